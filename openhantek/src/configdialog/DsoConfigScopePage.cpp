@@ -88,12 +88,15 @@ DsoConfigScopePage::DsoConfigScopePage( DsoSettings *settings, QWidget *parent )
     hasACmodificationCheckBox->setChecked( settings->scope.hasACmodification );
     toolTipVisibleCheckBox = new QCheckBox( tr( "Show tooltips for user interface (restart needed to apply the change)" ) );
     toolTipVisibleCheckBox->setChecked( settings->scope.toolTipVisible );
+    exportBlockInfoCheckBox = new QCheckBox( tr( "Export block number and acquisition time with CSV and JSON data" ) );
+    exportBlockInfoCheckBox->setChecked( settings->view.exportBlockInfo );
     configurationLayout = new QGridLayout();
     row = 0;
     configurationLayout->addWidget( saveOnExitCheckBox, row, 0 );
     configurationLayout->addWidget( saveNowButton, row, 1 );
     configurationLayout->addWidget( defaultSettingsCheckBox, ++row, 0, 1, 2 );
     configurationLayout->addWidget( toolTipVisibleCheckBox, ++row, 0, 1, 2 );
+    configurationLayout->addWidget( exportBlockInfoCheckBox, ++row, 0, 1, 2 );
     if ( settings->scope.hasACcoupling ) {
         hasACmodificationCheckBox->setChecked( true ); // check but do not show the box
     } else {
@@ -127,4 +130,5 @@ void DsoConfigScopePage::saveSettings() {
     settings->view.zoomImage = zoomImageCheckBox->isChecked();
     settings->view.zoomHeightIndex = zoomHeightComboBox->currentIndex();
     settings->view.exportScaleValue = exportScaleSpinBox->value();
+    settings->view.exportBlockInfo = exportBlockInfoCheckBox->isChecked();
 }
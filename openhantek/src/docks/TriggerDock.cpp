@@ -57,6 +57,56 @@ TriggerDock::TriggerDock( DsoSettingsScope *scope, const Dso::ControlSpecificati
         smoothComboBox->setToolTip( tr( "Trigger on fast, normal, or slow signals" ) );
     smoothComboBox->addItems( smoothStandardStrings );
 
+    typeLabel = new QLabel( tr( "Type" ) );
+    typeComboBox = new QComboBox();
+    if ( scope->toolTipVisible )
+        typeComboBox->setToolTip( tr( "Select the event that causes a trigger" ) );
+    for ( Dso::TriggerType type : Dso::TriggerTypeEnum )
+        typeComboBox->addItem( Dso::triggerTypeString( type ) );
+    conditionComboBox = new QComboBox();
+    if ( scope->toolTipVisible )
+        conditionComboBox->setToolTip( tr( "Trigger if the pulse width or slew time is less, greater or within the limits" ) );
+    for ( Dso::TriggerCondition condition : Dso::TriggerConditionEnum )
+        conditionComboBox->addItem( Dso::triggerConditionString( condition ) );
+
+    QList< double > timeSteps;
+    timeSteps << 1.0 << 2.0 << 5.0 << 10.0;
+    timeLabel = new QLabel( tr( "Time" ) );
+    time1SiSpinBox = new SiSpinBox( UNIT_SECONDS );
+    if ( scope->toolTipVisible )
+        time1SiSpinBox->setToolTip( tr( "Pulse width, slew time or timeout" ) );
+    time1SiSpinBox->setSteps( timeSteps );
+    time1SiSpinBox->setMinimum( 1e-8 );
+    time1SiSpinBox->setMaximum( 10.0 );
+    time2SiSpinBox = new SiSpinBox( UNIT_SECONDS );
+    if ( scope->toolTipVisible )
+        time2SiSpinBox->setToolTip( tr( "Upper time limit of the condition '<>'" ) );
+    time2SiSpinBox->setSteps( timeSteps );
+    time2SiSpinBox->setMinimum( 1e-8 );
+    time2SiSpinBox->setMaximum( 10.0 );
+
+    heightLabel = new QLabel( tr( "Height" ) );
+    heightSpinBox = new QDoubleSpinBox();
+    if ( scope->toolTipVisible )
+        heightSpinBox->setToolTip( tr( "Runt, window and slew rate: 2nd level = trigger level + height" ) );
+    heightSpinBox->setDecimals( 3 );
+    heightSpinBox->setSingleStep( 0.1 );
+    heightSpinBox->setMinimum( -100.0 );
+    heightSpinBox->setMaximum( 100.0 );
+    heightSpinBox->setSuffix( tr( " V" ) );
+    hysteresisLabel = new QLabel( tr( "Hysteresis" ) );
+    hysteresisSpinBox = new QDoubleSpinBox();
+    if ( scope->toolTipVisible )
+        hysteresisSpinBox->setToolTip( tr( "The signal must pass the trigger level -/+ hysteresis before the edge counts" ) );
+    hysteresisSpinBox->setDecimals( 3 );
+    hysteresisSpinBox->setSingleStep( 0.01 );
+    hysteresisSpinBox->setMinimum( 0.0 );
+    hysteresisSpinBox->setMaximum( 10.0 );
+    hysteresisSpinBox->setSuffix( tr( " V" ) );
+    multiCheckBox = new QCheckBox( tr( "All events" ) );
+    if ( scope->toolTipVisible )
+        multiCheckBox->setToolTip( tr( "Overlay the traces of all trigger events of a block, e.g. to catch jitter and glitches" ) );
+
     dockLayout = new QGridLayout();
     dockLayout->setColumnMinimumWidth( 0, 50 );
     dockLayout->setColumnStretch( 1, 1 ); // stretch 2nd (middle) column 1x
@@ -69,6 +119,17 @@ TriggerDock::TriggerDock( DsoSettingsScope *scope, const Dso::ControlSpecificati
     dockLayout->addWidget( slopeLabel, 2, 0 );
     dockLayout->addWidget( slopeComboBox, 2, 1 );
     dockLayout->addWidget( smoothComboBox, 2, 2 );
+    dockLayout->addWidget( typeLabel, 3, 0 );
+    dockLayout->addWidget( typeComboBox, 3, 1 );
+    dockLayout->addWidget( conditionComboBox, 3, 2 );
+    dockLayout->addWidget( timeLabel, 4, 0 );
+    dockLayout->addWidget( time1SiSpinBox, 4, 1 );
+    dockLayout->addWidget( time2SiSpinBox, 4, 2 );
+    dockLayout->addWidget( heightLabel, 5, 0 );
+    dockLayout->addWidget( heightSpinBox, 5, 1, 1, 2 ); // fill 1 row, 2 col
+    dockLayout->addWidget( hysteresisLabel, 6, 0 );
+    dockLayout->addWidget( hysteresisSpinBox, 6, 1, 1, 2 ); // fill 1 row, 2 col
+    dockLayout->addWidget( multiCheckBox, 7, 1, 1, 2 );     // fill 1 row, 2 col
 
     dockWidget = new QWidget();
     SetupDockWidget( this, dockWidget, dockLayout );
@@ -97,6 +158,42 @@ TriggerDock::TriggerDock( DsoSettingsScope *scope, const Dso::ControlSpecificati
                  this->scope->trigger.smooth = index;
                  emit smoothChanged( index );
              } );
+    connect( typeComboBox, static_cast< void ( QComboBox::* )( int ) >( &QComboBox::currentIndexChanged ), this,
+             [ this ]( int index ) {
+                 this->scope->trigger.type = Dso::TriggerType( index );
+                 enableTypeParameters();
+                 emit typeChanged( this->scope->trigger.type );
+             } );
+    connect( conditionComboBox, static_cast< void ( QComboBox::* )( int ) >( &QComboBox::currentIndexChanged ), this,
+             [ this ]( int index ) {
+                 this->scope->trigger.condition = Dso::TriggerCondition( index );
+                 enableTypeParameters();
+                 emit conditionChanged( this->scope->trigger.condition );
+             } );
+    connect( time1SiSpinBox, static_cast< void ( QDoubleSpinBox::* )( double ) >( &QDoubleSpinBox::valueChanged ), this,
+             [ this ]( double value ) {
+                 this->scope->trigger.time1 = value;
+                 emit time1Changed( value );
+             } );
+    connect( time2SiSpinBox, static_cast< void ( QDoubleSpinBox::* )( double ) >( &QDoubleSpinBox::valueChanged ), this,
+             [ this ]( double value ) {
+                 this->scope->trigger.time2 = value;
+                 emit time2Changed( value );
+             } );
+    connect( heightSpinBox, static_cast< void ( QDoubleSpinBox::* )( double ) >( &QDoubleSpinBox::valueChanged ), this,
+             [ this ]( double value ) {
+                 this->scope->trigger.height = value;
+                 emit heightChanged( value );
+             } );
+    connect( hysteresisSpinBox, static_cast< void ( QDoubleSpinBox::* )( double ) >( &QDoubleSpinBox::valueChanged ), this,
+             [ this ]( double value ) {
+                 this->scope->trigger.hysteresis = value;
+                 emit hysteresisChanged( value );
+             } );
+    connect( multiCheckBox, &QAbstractButton::toggled, this, [ this ]( bool checked ) {
+        this->scope->trigger.multiTrigger = checked;
+        emit multiTriggerChanged( checked );
+    } );
 }
 
 void TriggerDock::loadSettings( DsoSettingsScope *scope ) {
@@ -109,6 +206,18 @@ void TriggerDock::loadSettings( DsoSettingsScope *scope ) {
     setSlope( scope->trigger.slope );
     setSource( scope->trigger.source );
     setSmooth( scope->trigger.smooth );
+    setType( scope->trigger.type );
+    setCondition( scope->trigger.condition );
+    QSignalBlocker time1Blocker( time1SiSpinBox );
+    time1SiSpinBox->setValue( scope->trigger.time1 );
+    QSignalBlocker time2Blocker( time2SiSpinBox );
+    time2SiSpinBox->setValue( scope->trigger.time2 );
+    QSignalBlocker heightBlocker( heightSpinBox );
+    heightSpinBox->setValue( scope->trigger.height );
+    QSignalBlocker hysteresisBlocker( hysteresisSpinBox );
+    hysteresisSpinBox->setValue( scope->trigger.hysteresis );
+    QSignalBlocker multiBlocker( multiCheckBox );
+    multiCheckBox->setChecked( scope->trigger.multiTrigger );
 }
 
 
@@ -165,3 +274,31 @@ void TriggerDock::setSmooth( int smooth ) {
     QSignalBlocker blocker( smoothComboBox );
     smoothComboBox->setCurrentIndex( int( smooth ) );
 }
+
+void TriggerDock::setType( Dso::TriggerType type ) {
+    if ( scope->verboseLevel > 2 )
+        qDebug() << "  TDock::setType()" << int( type );
+    QSignalBlocker blocker( typeComboBox );
+    typeComboBox->setCurrentIndex( int( type ) );
+    enableTypeParameters();
+}
+
+void TriggerDock::setCondition( Dso::TriggerCondition condition ) {
+    if ( scope->verboseLevel > 2 )
+        qDebug() << "  TDock::setCondition()" << int( condition );
+    QSignalBlocker blocker( conditionComboBox );
+    conditionComboBox->setCurrentIndex( int( condition ) );
+    enableTypeParameters();
+}
+
+/// \brief Enable only the parameters that are used by the selected trigger type
+void TriggerDock::enableTypeParameters() {
+    const Dso::TriggerType type = Dso::TriggerType( typeComboBox->currentIndex() );
+    const bool timed = type == Dso::TriggerType::PulseWidth || type == Dso::TriggerType::SlewRate;
+    conditionComboBox->setEnabled( timed );
+    time1SiSpinBox->setEnabled( timed || type == Dso::TriggerType::Timeout );
+    const bool within = Dso::TriggerCondition( conditionComboBox->currentIndex() ) == Dso::TriggerCondition::Within;
+    time2SiSpinBox->setEnabled( timed && within );
+    heightSpinBox->setEnabled( type == Dso::TriggerType::Runt || type == Dso::TriggerType::WindowEnter ||
+                               type == Dso::TriggerType::WindowExit || type == Dso::TriggerType::SlewRate );
+}
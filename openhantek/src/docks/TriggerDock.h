@@ -5,6 +5,7 @@
 #include <QCheckBox>
 #include <QComboBox>
 #include <QDockWidget>
+#include <QDoubleSpinBox>
 #include <QGridLayout>
 #include <QLabel>
 
@@ -17,7 +18,7 @@ struct ControlSpecification;
 }
 
 /// \brief Dock window for the trigger settings.
-/// It contains the settings for the trigger mode, source and slope.
+/// It contains the settings for the trigger mode, source, slope and the trigger type with its parameters.
 class TriggerDock : public QDockWidget {
     Q_OBJECT
 
@@ -45,6 +46,14 @@ class TriggerDock : public QDockWidget {
     /// \param slope The trigger slope.
     void setSlope( Dso::Slope slope );
 
+    /// \brief Changes the trigger type and enables the parameters used by this type.
+    /// \param type The event that causes a trigger.
+    void setType( Dso::TriggerType type );
+
+    /// \brief Changes the time condition of the pulse width and slew rate trigger.
+    /// \param condition Less, greater or within time1 .. time2.
+    void setCondition( Dso::TriggerCondition condition );
+
   public slots:
     /// \brief Loads settings into GUI
     /// \param scope Settings to load
@@ -54,15 +63,28 @@ class TriggerDock : public QDockWidget {
   protected:
     void closeEvent( QCloseEvent *event ) override;
 
-    QGridLayout *dockLayout;   ///< The main layout for the dock window
-    QWidget *dockWidget;       ///< The main widget for the dock window
-    QLabel *modeLabel;         ///< The label for the trigger mode combobox
-    QLabel *sourceLabel;       ///< The label for the trigger source combobox
-    QLabel *slopeLabel;        ///< The label for the trigger slope combobox
-    QComboBox *modeComboBox;   ///< Select the triggering mode
-    QComboBox *sourceComboBox; ///< Select the source for triggering
-    QComboBox *smoothComboBox; ///< Select the filter for triggering
-    QComboBox *slopeComboBox;  ///< Select the slope that causes triggering
+    QGridLayout *dockLayout;           ///< The main layout for the dock window
+    QWidget *dockWidget;               ///< The main widget for the dock window
+    QLabel *modeLabel;                 ///< The label for the trigger mode combobox
+    QLabel *sourceLabel;               ///< The label for the trigger source combobox
+    QLabel *slopeLabel;                ///< The label for the trigger slope combobox
+    QComboBox *modeComboBox;           ///< Select the triggering mode
+    QComboBox *sourceComboBox;         ///< Select the source for triggering
+    QComboBox *smoothComboBox;         ///< Select the filter for triggering
+    QComboBox *slopeComboBox;          ///< Select the slope that causes triggering
+    QLabel *typeLabel;                 ///< The label for the trigger type combobox
+    QLabel *timeLabel;                 ///< The label for the trigger time spinboxes
+    QLabel *heightLabel;               ///< The label for the 2nd level spinbox
+    QLabel *hysteresisLabel;           ///< The label for the hysteresis spinbox
+    QComboBox *typeComboBox;           ///< Select the event that causes triggering
+    QComboBox *conditionComboBox;      ///< Select the time condition
+    SiSpinBox *time1SiSpinBox;         ///< Pulse width, slew rate or timeout time
+    SiSpinBox *time2SiSpinBox;         ///< Upper time limit of the condition "within"
+    QDoubleSpinBox *heightSpinBox;     ///< Distance of the 2nd level for runt, window and slew rate
+    QDoubleSpinBox *hysteresisSpinBox; ///< Noise rejection of the trigger level
+    QCheckBox *multiCheckBox;          ///< Show the traces of all trigger events
+
+    void enableTypeParameters();
 
     DsoSettingsScope *scope; ///< The settings provided by the parent class
     const Dso::ControlSpecification *mSpec;
@@ -71,8 +93,15 @@ class TriggerDock : public QDockWidget {
     QStringList smoothStandardStrings; ///< Strings for the standard trigger filtering
 
   signals:
-    void modeChanged( Dso::TriggerMode ); ///< The trigger mode has been changed
-    void sourceChanged( int id );         ///< The trigger source has been changed
-    void smoothChanged( int smooth );     ///< The trigger smoothing has been changed
-    void slopeChanged( Dso::Slope );      ///< The trigger slope has been changed
+    void modeChanged( Dso::TriggerMode );           ///< The trigger mode has been changed
+    void sourceChanged( int id );                   ///< The trigger source has been changed
+    void smoothChanged( int smooth );               ///< The trigger smoothing has been changed
+    void slopeChanged( Dso::Slope );                ///< The trigger slope has been changed
+    void typeChanged( Dso::TriggerType );           ///< The trigger type has been changed
+    void conditionChanged( Dso::TriggerCondition ); ///< The time condition has been changed
+    void time1Changed( double time );               ///< The pulse width, slew rate or timeout time has been changed
+    void time2Changed( double time );               ///< The upper time limit has been changed
+    void heightChanged( double height );            ///< The 2nd level distance has been changed
+    void hysteresisChanged( double hysteresis );    ///< The trigger hysteresis has been changed
+    void multiTriggerChanged( bool multi );         ///< The display of all trigger events has been switched
 };
@@ -157,6 +157,22 @@ void DsoSettings::load() {
         scope.trigger.source = storeSettings->value( "source" ).toInt();
     if ( storeSettings->contains( "smooth" ) )
         scope.trigger.smooth = storeSettings->value( "smooth" ).toInt();
+    if ( storeSettings->contains( "type" ) )
+        scope.trigger.type =
+            Dso::TriggerType( qMin( storeSettings->value( "type" ).toUInt(), unsigned( Dso::TriggerType::Timeout ) ) );
+    if ( storeSettings->contains( "condition" ) )
+        scope.trigger.condition = Dso::TriggerCondition(
+            qMin( storeSettings->value( "condition" ).toUInt(), unsigned( Dso::TriggerCondition::Within ) ) );
+    if ( storeSettings->contains( "time1" ) )
+        scope.trigger.time1 = storeSettings->value( "time1" ).toDouble();
+    if ( storeSettings->contains( "time2" ) )
+        scope.trigger.time2 = storeSettings->value( "time2" ).toDouble();
+    if ( storeSettings->contains( "height" ) )
+        scope.trigger.height = storeSettings->value( "height" ).toDouble();
+    if ( storeSettings->contains( "hysteresis" ) )
+        scope.trigger.hysteresis = storeSettings->value( "hysteresis" ).toDouble();
+    if ( storeSettings->contains( "multiTrigger" ) )
+        scope.trigger.multiTrigger = storeSettings->value( "multiTrigger" ).toBool();
     storeSettings->endGroup(); // trigger
     // Spectrum
     for ( ChannelID channel = 0; channel < scope.spectrum.size(); ++channel ) {
@@ -319,6 +335,8 @@ void DsoSettings::load() {
         view.zoomImage = storeSettings->value( "zoomImage" ).toBool();
     if ( storeSettings->contains( "exportScaleValue" ) )
         view.exportScaleValue = storeSettings->value( "exportScaleValue" ).toInt();
+    if ( storeSettings->contains( "exportBlockInfo" ) )
+        view.exportBlockInfo = storeSettings->value( "exportBlockInfo" ).toBool();
     if ( storeSettings->contains( "cursorGridPosition" ) )
         view.cursorGridPosition = Qt::ToolBarArea( storeSettings->value( "cursorGridPosition" ).toUInt() );
     if ( storeSettings->contains( "cursorsVisible" ) )
@@ -389,6 +407,13 @@ void DsoSettings::save() {
     storeSettings->setValue( "slope", unsigned( scope.trigger.slope ) );
     storeSettings->setValue( "source", scope.trigger.source );
     storeSettings->setValue( "smooth", scope.trigger.smooth );
+    storeSettings->setValue( "type", unsigned( scope.trigger.type ) );
+    storeSettings->setValue( "condition", unsigned( scope.trigger.condition ) );
+    storeSettings->setValue( "time1", scope.trigger.time1 );
+    storeSettings->setValue( "time2", scope.trigger.time2 );
+    storeSettings->setValue( "height", scope.trigger.height );
+    storeSettings->setValue( "hysteresis", scope.trigger.hysteresis );
+    storeSettings->setValue( "multiTrigger", scope.trigger.multiTrigger );
     storeSettings->endGroup(); // trigger
     // Spectrum
     for ( ChannelID channel = 0; channel < scope.spectrum.size(); ++channel ) {
@@ -485,6 +510,7 @@ void DsoSettings::save() {
     storeSettings->setValue( "zoomHeightIndex", view.zoomHeightIndex );
     storeSettings->setValue( "zoomImage", view.zoomImage );
     storeSettings->setValue( "exportScaleValue", view.exportScaleValue );
+    storeSettings->setValue( "exportBlockInfo", view.exportBlockInfo );
     storeSettings->setValue( "cursorGridPosition", view.cursorGridPosition );
     storeSettings->setValue( "cursorsVisible", view.cursorsVisible );
     storeSettings->endGroup(); // view
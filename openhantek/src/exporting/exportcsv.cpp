@@ -50,6 +50,11 @@ void ExporterCSV::fillHeaders( QTextStream &csvStream, const ExporterData &dto,
     std::vector< const SampleValues * > voltageData = dto.getVoltageData();
     std::vector< const SampleValues * > spectrumData = dto.getSpectrumData();
 
+    // optional comment line with the acquisition time of the block, skipped by most CSV readers
+    if ( registry->settings->view.exportBlockInfo )
+        csvStream << "# block " << dto.getTag() << ", " << dto.getDateTime().toString( "yyyy-MM-ddThh:mm:ss.zzz" )
+                  << ", steady clock " << dto.getTimeStart() << " s .. " << dto.getTimeEnd() << " s\n";
+
     csvStream << "\"t / s\"";
 
     // Channels
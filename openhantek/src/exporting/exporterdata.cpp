@@ -10,6 +10,11 @@ ExporterData::ExporterData( const std::shared_ptr< PPresult > &data, const DsoSe
     _chCount = scope.voltage.size();
     _voltageData = std::vector< const SampleValues * >( size_t( _chCount ), nullptr );
     _spectrumData = std::vector< const SampleValues * >( size_t( _chCount ), nullptr );
+    _tag = data->tag;
+    _timeStart = data->timeStart;
+    _timeEnd = data->timeEnd;
+    // map the steady clock to the wall clock
+    _dateTime = QDateTime::currentDateTime().addMSecs( -( steadyTime() - _timeStart ) / 1000000 );
 
     for ( ChannelID channel = 0; channel < _chCount; ++channel ) {
         if ( data->data( channel ) ) {
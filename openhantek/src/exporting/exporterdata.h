@@ -6,6 +6,7 @@
 #include "post/ppresult.h"
 #include "scopesettings.h"
 
+#include <QDateTime>
 #include <memory>
 #include <vector>
 
@@ -20,6 +21,12 @@ class ExporterData {
     const double &getFreqInterval() const { return _freqInterval; }
     std::vector< const SampleValues * > const &getVoltageData() const { return _voltageData; }
     std::vector< const SampleValues * > const &getSpectrumData() const { return _spectrumData; }
+    const unsigned &getTag() const { return _tag; }
+    /// steady clock time of the block's transfer start and end in s
+    double getTimeStart() const { return _timeStart * 1e-9; }
+    double getTimeEnd() const { return _timeEnd * 1e-9; }
+    /// wall clock time of the block's transfer start
+    const QDateTime &getDateTime() const { return _dateTime; }
 
   private:
     size_t _chCount;
@@ -29,4 +36,8 @@ class ExporterData {
     double _freqInterval;
     std::vector< const SampleValues * > _voltageData;
     std::vector< const SampleValues * > _spectrumData;
+    unsigned _tag;
+    int64_t _timeStart;
+    int64_t _timeEnd;
+    QDateTime _dateTime;
 };
@@ -51,8 +51,18 @@ void ExporterJSON::fillData( QTextStream &jsonStream, const ExporterData &dto )
     std::vector< const SampleValues * > voltageData = dto.getVoltageData();
     std::vector< const SampleValues * > spectrumData = dto.getSpectrumData();
 
-    jsonStream << "[\n";
     const char *indent = "  ";
+    const bool blockInfo = registry->settings->view.exportBlockInfo;
+    if ( blockInfo ) { // optional: an object with the block info and the array of rows as "samples"
+        jsonStream << "{\n";
+        jsonStream << indent << "\"block\": " << dto.getTag() << ",\n";
+        jsonStream << indent << "\"date\": \"" << dto.getDateTime().toString( "yyyy-MM-ddThh:mm:ss.zzz" ) << "\",\n";
+        jsonStream << indent << "\"timeStart\": " << dto.getTimeStart() << ",\n"; // steady clock
+        jsonStream << indent << "\"timeEnd\": " << dto.getTimeEnd() << ",\n";
+        jsonStream << indent << "\"samples\": [\n";
+    } else { // default: the array of rows
+        jsonStream << "[\n";
+    }
 
     for ( unsigned int row = 0; row < dto.getMaxRow(); ++row ) {
         jsonStream << indent << "{\n";
@@ -93,7 +103,12 @@ void ExporterJSON::fillData( QTextStream &jsonStream, const ExporterData &dto )
             jsonStream << ',';
         jsonStream << '\n';
     }
-    jsonStream << "]\n";
+    if ( blockInfo ) {
+        jsonStream << indent << "]\n";
+        jsonStream << "}\n";
+    } else {
+        jsonStream << "]\n";
+    }
 }
 
 bool ExporterJSON::save() {
@@ -883,10 +883,20 @@ void GlScope::drawVoltageChannelGraph( ChannelID channel, Graph &graph, int hist
         return;
 
     m_program->setUniformValue( colorLocation, view->colors->voltage[ channel ].darker( 100 + 10 * historyIndex ) );
-    Graph::VaoCount &v = graph.vaoVoltage[ channel ];
+    const GLenum dMode = ( view->interpolation == Dso::INTERPOLATION_OFF ) ? GL_POINTS : GL_LINE_STRIP;
 
+    // multi trigger: the traces of the further events of the block below the triggered trace
+    if ( channel < graph.segmentDots.size() && !graph.segmentDots[ channel ].empty() ) {
+        QOpenGLVertexArrayObject::Binder m( graph.vaoSegments[ channel ].first );
+        GLint first = 0;
+        for ( GLsizei dots : graph.segmentDots[ channel ] ) {
+            context()->functions()->glDrawArrays( dMode, first, dots );
+            first += dots;
+        }
+    }
+
+    Graph::VaoCount &v = graph.vaoVoltage[ channel ];
     QOpenGLVertexArrayObject::Binder b( v.first );
-    const GLenum dMode = ( view->interpolation == Dso::INTERPOLATION_OFF ) ? GL_POINTS : GL_LINE_STRIP;
     context()->functions()->glDrawArrays( dMode, 0, v.second );
 }
 
@@ -18,6 +18,8 @@ void Graph::writeData( PPresult *data, QOpenGLShaderProgram *program, int vertex
         neededMemory += int( cg.size() * sizeof( QVector3D ) );
     for ( ChannelGraph &cg : data->vaChannelSpectrum )
         neededMemory += int( cg.size() * sizeof( QVector3D ) );
+    for ( ChannelGraph &cg : data->vaChannelSegments )
+        neededMemory += int( cg.size() * sizeof( QVector3D ) );
 
     buffer.bind();
     program->bind();
@@ -95,6 +97,30 @@ void Graph::writeData( PPresult *data, QOpenGLShaderProgram *program, int vertex
         }
     }
 
+    // Multi trigger traces, all traces of a channel are in one range and drawn as separate strips
+    if ( vaoSegments.size() < data->vaChannelSegments.size() ) // keep the VAOs if there are no traces (XY mode)
+        vaoSegments.resize( data->vaChannelSegments.size() );
+    segmentDots.assign( vaoSegments.size(), std::vector< GLsizei >() );
+    for ( ChannelID channel = 0; channel < data->vaChannelSegments.size(); ++channel ) {
+        VaoCount &m = vaoSegments[ channel ];
+        if ( !m.first ) {
+            m.first = new QOpenGLVertexArrayObject;
+            if ( !m.first->create() )
+                throw new std::runtime_error( "QOpenGLVertexArrayObject create failed" );
+        }
+        ChannelGraph &gSegments = data->vaChannelSegments[ channel ];
+        m.first->bind();
+        int dataSize = int( gSegments.size() * sizeof( QVector3D ) );
+        buffer.write( offset, gSegments.data(), dataSize );
+        program->enableAttributeArray( vertexLocation );
+        program->setAttributeBuffer( vertexLocation, GL_FLOAT, offset, 3, 0 );
+        m.first->release();
+        m.second = int( gSegments.size() );
+        offset += dataSize;
+        if ( channel < data->segmentDots.size() )
+            segmentDots[ channel ].assign( data->segmentDots[ channel ].begin(), data->segmentDots[ channel ].end() );
+    }
+
     buffer.release();
 }
 
@@ -111,6 +137,10 @@ Graph::~Graph() {
         vao.first->destroy();
         delete vao.first;
     }
+    for ( auto &vao : vaoSegments ) {
+        vao.first->destroy();
+        delete vao.first;
+    }
     if ( buffer.isCreated() ) {
         buffer.destroy();
     }
@@ -27,4 +27,6 @@ struct Graph {
     std::vector< VaoCount > vaoVoltage;
     std::vector< VaoCount > vaoHistogram;
     std::vector< VaoCount > vaoSpectrum;
+    std::vector< VaoCount > vaoSegments;               ///< Multi trigger: the further traces of each voltage channel
+    std::vector< std::vector< GLsizei > > segmentDots; ///< Multi trigger: number of dots of each further trace
 };
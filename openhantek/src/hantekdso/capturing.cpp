@@ -3,6 +3,7 @@
 // #define TIMESTAMPDEBUG
 
 #include "capturing.h"
+#include "rawplayer.h"
 #include "usb/scopedevice.h"
 #include <QDebug>
 #include <cmath>
@@ -28,9 +29,13 @@ void CapturingThread::run() {
         if ( hdc->scope ) { // device is initialized
             if ( hdc->samplingUI ) {
                 capture();
-                // add user defined hold-off time to lower CPU load
-                QThread::msleep( unsigned( 1000 * hdc->scope->horizontal.acquireInterval ) );
+                // add user defined hold-off time to lower CPU load, a sequence is captured as fast as possible
+                if ( hdc->scope->horizontal.acquireInterval > 0 && !hdc->segmentPool.isActive() ) {
+                    hdc->scopeDevice->stopStreaming(); // gaps are intended, do not let the stream overrun
+                    QThread::msleep( unsigned( 1000 * hdc->scope->horizontal.acquireInterval ) );
+                }
             } else {
+                hdc->scopeDevice->stopStreaming();
                 QThread::msleep( unsigned( hdc->displayInterval ) ); // run slowly
             }
         }
@@ -48,20 +53,27 @@ static double id2sr( uint8_t timediv ) {
 }
 
 
+void CapturingThread::fillBlock( Raw *raw ) {
+    raw->channels = channels;
+    raw->samplerate = samplerate;
+    raw->oversampling = oversampling;
+    raw->gainValue[ 0 ] = gainValue[ 0 ];
+    raw->gainValue[ 1 ] = gainValue[ 1 ];
+    raw->gainIndex[ 0 ] = gainIndex[ 0 ];
+    raw->gainIndex[ 1 ] = gainIndex[ 1 ];
+    raw->freeRun = freeRun;
+    raw->valid = valid;
+    raw->tag = tag;
+    raw->received = received;
+    raw->timeStart = timeStart;
+    raw->timeEnd = timeEnd;
+}
+
+
 void CapturingThread::xferSamples() {
-    QWriteLocker locker( &hdc->raw.lock );
-    if ( !freeRun )
-        swap( data, hdc->raw.data );
-    hdc->raw.channels = channels;
-    hdc->raw.samplerate = samplerate;
-    hdc->raw.oversampling = oversampling;
-    hdc->raw.gainValue[ 0 ] = gainValue[ 0 ];
-    hdc->raw.gainValue[ 1 ] = gainValue[ 1 ];
-    hdc->raw.gainIndex[ 0 ] = gainIndex[ 0 ];
-    hdc->raw.gainIndex[ 1 ] = gainIndex[ 1 ];
-    hdc->raw.freeRun = freeRun;
-    hdc->raw.valid = valid;
-    hdc->raw.tag = tag;
+    // fill in the settings and publish the block, in free run mode the samples are in hdc->rollRaw
+    fillBlock( hdc->rawQueue.writeBlock() );
+    hdc->rawQueue.commitBlock();
 }
 
 
@@ -69,8 +81,8 @@ void CapturingThread::capture() {
     if ( !hdc->samplingStarted )
         return;
     int errorCode;
-    // Send all pending control commands
-    ControlCommand *controlCommand = hdc->firstControlCommand;
+    // Send all pending control commands, but not while a batch of setting changes is not yet complete
+    ControlCommand *controlCommand = hdc->commandBatch.load() ? nullptr : hdc->firstControlCommand;
     while ( controlCommand ) {
         if ( controlCommand->pending ) {
             switch ( int( controlCommand->code ) ) {
@@ -98,13 +110,12 @@ void CapturingThread::capture() {
                 effectiveSamplerate = hdc->specification->fixedSampleRates[ sampleIndex ].samplerate;
                 if ( !realSlow && effectiveSamplerate < 10e3 &&
                      hdc->scope->trigger.mode == Dso::TriggerMode::ROLL ) { // switch to real slow rolling
-                    for ( auto it = data.begin(); it != data.end(); ) {
-                        *it++ = hdc->channelOffset[ 0 ]; // fill ch0 with "zeros"
+                    hdc->rollRaw.rollMode = false;
+                    auto &rollData = hdc->rollRaw.data;
+                    for ( auto it = rollData.begin(); it != rollData.end(); ) {
+                        *it++ = hdc->channelOffset[ 0 ]; // fill ch0 with "zeros" -> "clear screen"
                         *it++ = hdc->channelOffset[ 1 ]; // fill ch1 with "zeros"
                     }
-                    QWriteLocker locker( &hdc->raw.lock );
-                    hdc->raw.rollMode = false;
-                    swap( data, hdc->raw.data ); // "clear screen"
                 }
                 realSlow = effectiveSamplerate < 10e3;
                 if ( realSlow ) {        // roll mode possible?
@@ -116,6 +127,12 @@ void CapturingThread::capture() {
                 }
                 break;
             }
+            if ( !controlCommand->isChanged() ) { // the device has this setting already, save the round-trip
+                controlCommand->pending = false;
+                controlCommand = controlCommand->next;
+                continue;
+            }
+            hdc->scopeDevice->stopStreaming(); // data in flight was sampled with the old settings
             QString name = "";
             if ( controlCommand->code >= 0xe0 && controlCommand->code <= 0xe6 )
                 name = controlNames[ controlCommand->code - 0xe0 ];
@@ -132,9 +149,11 @@ void CapturingThread::capture() {
                         return;
                     }
                 } else {
+                    controlCommand->markSent();
                     controlCommand->pending = false;
                 }
             } else {
+                controlCommand->markSent();
                 controlCommand->pending = false;
             }
         }
@@ -142,19 +161,31 @@ void CapturingThread::capture() {
     }
     valid = true;
     freeRun = hdc->triggerModeNONE() && realSlow;
-    // sample step by step into the target if rollMode, else buffer and switch one big block
-    dp = freeRun ? &hdc->raw.data : &data;
     rawSamplesize = hdc->grossSampleCount( hdc->getSamplesize() * oversampling ) * channels;
+    // sample step by step into the shared roll buffer if rollMode, else fill one block of the queue
+    // or - in sequence mode - the next segment of the pool
+    segment = freeRun ? nullptr : hdc->segmentPool.nextSegment( rawSamplesize );
+    dp = freeRun ? &hdc->rollRaw.data : segment ? &segment->data : &hdc->rawQueue.writeBlock()->data;
     dp->resize( rawSamplesize, 0x80 );
-    if ( tag && freeRun ) // in free run mode transfer settings immediately
+    if ( tag && freeRun ) { // in free run mode transfer settings immediately
+        timeStart = timeEnd = steadyTime(); // the roll buffer is updated continuously
         xferSamples();
+    }
     if ( 0 == ++tag )
         ++tag; // skip tag==0
+    hdc->scopeDevice->blockStarted();
+    if ( !freeRun )
+        timeStart = steadyTime();
     if ( hdc->scopeDevice->isRealHW() ) {
         received = getRealSamples();
+    } else if ( hdc->scopeDevice->isPlayback() ) {
+        received = getPlaybackSamples();
     } else {
         received = getDemoSamples();
     }
+    hdc->scopeDevice->blockFinished();
+    if ( !freeRun )
+        timeEnd = steadyTime();
     if ( received != rawSamplesize ) {
         // qDebug() << "retval != rawSamplesize" << received << rawSamplesize;
         auto end = dp->end();
@@ -163,27 +194,85 @@ void CapturingThread::capture() {
             *it++ = hdc->channelOffset[ 1 ]; // fill ch1 with "zeros"
         }
         valid = false;
-        hdc->raw.rollMode = false;
+        hdc->rollRaw.rollMode = false;
     } else {
-        hdc->raw.rollMode = true; // one complete buffer available, start to roll
+        hdc->rollRaw.rollMode = true; // one complete buffer available, start to roll
     }
-    if ( !freeRun ) // in normal capturing mode transfer after capturing one block
+    if ( hdc->rawRecorder.isRecording() ) // store the unconverted samples
+        recordSamples();
+    if ( segment ) { // sequence mode: keep the block in the pool, it is processed after the sequence is complete
+        fillBlock( segment );
+        hdc->segmentPool.commitSegment();
+    } else if ( !freeRun ) { // in normal capturing mode transfer after capturing one block
         xferSamples();
+    }
+}
+
+
+void CapturingThread::recordSamples() {
+    RawBlockHeader header;
+    header.size = received;
+    header.tag = tag;
+    header.samplerate = samplerate;
+    header.oversampling = uint16_t( oversampling );
+    header.channels = uint8_t( channels );
+    header.valid = valid;
+    header.gainValue[ 0 ] = uint8_t( gainValue[ 0 ] );
+    header.gainValue[ 1 ] = uint8_t( gainValue[ 1 ] );
+    header.gainIndex[ 0 ] = uint8_t( gainIndex[ 0 ] );
+    header.gainIndex[ 1 ] = uint8_t( gainIndex[ 1 ] );
+    if ( !hdc->rawRecorder.write( header, dp->data() ) ) {
+        emit hdc->statusMessage( tr( "Recording stopped: %1" ).arg( hdc->rawRecorder.getErrorString() ), 0 );
+        emit hdc->recordingStopped();
+    }
 }
 
 
 unsigned CapturingThread::getRealSamples() {
     int errorCode;
-    errorCode = hdc->scopeDevice->controlWrite( hdc->getCommand( ControlCode::CONTROL_STARTSAMPLING ) );
-    if ( errorCode < 0 ) {
-        qWarning() << "controlWrite: Getting sample data failed: " << libUsbErrorString( errorCode );
-        dp->clear();
-        return 0;
+    ScopeDevice *scopeDevice = hdc->scopeDevice;
+    // fast sampling can stream continuously without gaps between the blocks, roll mode reads small blocks
+    const bool streaming = scopeDevice->isStreamingMode() && !realSlow;
+    if ( !streaming )
+        scopeDevice->stopStreaming();
+    if ( !scopeDevice->isStreaming() ) { // (re)start the sampling
+        if ( streaming ) {
+            // transfer about 10 ms of data with each async transfer
+            unsigned transferSize = qBound( unsigned( HANTEK_STREAM_TRANSFER_MIN ), unsigned( samplerate * channels / 100 ),
+                                            unsigned( HANTEK_STREAM_TRANSFER_MAX ) );
+            errorCode = scopeDevice->startStreaming( transferSize );
+            if ( errorCode < 0 ) {
+                qWarning() << "startStreaming: Getting sample data failed: " << libUsbErrorString( errorCode );
+                dp->clear();
+                return 0;
+            }
+        }
+        errorCode = scopeDevice->controlWrite( hdc->getCommand( ControlCode::CONTROL_STARTSAMPLING ) );
+        if ( errorCode < 0 ) {
+            scopeDevice->stopStreaming();
+            qWarning() << "controlWrite: Getting sample data failed: " << libUsbErrorString( errorCode );
+            dp->clear();
+            return 0;
+        }
     }
     // Save raw data to temporary buffer
     // timestampDebug( QString( "Request packet %1: %2 bytes" ).arg( tag ).arg( rawSamplesize ) );
-    hdc->raw.received = 0;
-    int retval = hdc->scopeDevice->bulkReadMulti( dp->data(), rawSamplesize, realSlow, hdc->raw.received );
+    hdc->rollRaw.received = 0;
+    int retval;
+    if ( streaming ) {
+        retval = scopeDevice->bulkReadStream( dp->data(), rawSamplesize, hdc->rollRaw.received );
+        unsigned overruns = scopeDevice->getStreamOverruns();
+        if ( overruns != streamOverruns ) { // gap in the stream, report it
+            if ( hdc->verboseLevel > 2 )
+                qDebug() << "  CapturingThread::getRealSamples() stream overrun" << overruns << "tag" << tag;
+            emit hdc->statusMessage( tr( "USB overrun, %1 gaps in the data stream" ).arg( overruns ), 2000 );
+            streamOverruns = overruns;
+        }
+    } else {
+        retval = scopeDevice->bulkReadMulti( dp->data(), rawSamplesize,
+                                             realSlow ? ScopeDevice::rollChunkSize( samplerate * channels ) : 0,
+                                             hdc->rollRaw.received );
+    }
     if ( retval < 0 ) {
         if ( retval == LIBUSB_ERROR_NO_DEVICE )
             hdc->scopeDevice->disconnectFromDevice();
@@ -198,61 +287,63 @@ unsigned CapturingThread::getRealSamples() {
 
 unsigned CapturingThread::getDemoSamples() {
     const uint8_t binaryOffset = 0x80; // ADC format: binary offset
-    const int8_t V_zero = 0;           // ADC = 0V
-    const int8_t V_plus_1 = 25;        // ADC = 1V
-    const int8_t V_plus_2 = 50;        // ADC = 2V
-    const int8_t V_minus_1 = -25;      // ADC = -1V
-    const int8_t V_minus_2 = -50;      // ADC = -2V
-    const int gain1 = int( gainValue[ 0 ] );
-    const int gain2 = int( gainValue[ 1 ] );
-    static int ch1 = 0;
-    static int ch2 = 0;
-    static int counter = 0;
+    const bool ac[ 2 ] = { hdc->scope->coupling( 0, hdc->specification ) == Dso::Coupling::AC,
+                           hdc->scope->coupling( 1, hdc->specification ) == Dso::Coupling::AC };
     unsigned received = 0;
-    hdc->raw.received = 0;
+    hdc->rollRaw.received = 0;
     // timestampDebug( QString( "Request dummy packet %1: %2 bytes" ).arg( tag ).arg( rawSamplesize ) );
-    int deltaT = 99;
-    // deltaT (=99) defines the frequency of the dummy signals:
-    // ch1 = 1 kHz and ch2 = 500 Hz
-    // uncomment the next two lines to disable sample slowdown for low sample rates
-    // if ( samplerate < 10e6 )
-    //    deltaT = int( round( deltaT * samplerate / 10e6 ) );
-    // adapt demo samples for high sample rates >10 MS/s
-    if ( samplerate > 10e6 )
-        deltaT = int( round( deltaT * samplerate / 10e6 ) );
-    const unsigned packetLength = 512 * 78; // 50 blocks for one screen width of 20000
-    unsigned block = 0;
+    const unsigned packetLength = ScopeDevice::rollChunkSize( samplerate * channels ); // same chunks as the real HW
     dp->resize( rawSamplesize, binaryOffset );
-    auto end = dp->end();
-    unsigned packet = 0;
-    // bool couplingAC1 = hdc->scope->coupling( 0, hdc->specification ) == Dso::Coupling::AC; // not yet used
-    bool couplingAC2 = hdc->scope->coupling( 1, hdc->specification ) == Dso::Coupling::AC;
-    for ( auto it = dp->begin(); it != end; ++it ) {
-        if ( ++counter >= deltaT ) {
-            counter = 0;
-            if ( --ch1 < V_minus_2 ) {
-                ch1 = V_plus_2;
-                if ( couplingAC2 )
-                    ch2 = ch2 <= V_zero ? V_plus_1 : V_minus_1; // -1V <-> +1V
-                else
-                    ch2 = ch2 <= V_plus_1 ? V_plus_2 : V_zero; // 0V <-> 2V
-            }
-        }
-        *it = uint8_t( qBound( 0, ch1 * gain1 + binaryOffset, 0xFF ) ); // clip if outside 8bit range
-        ++received;
-        if ( 2 == channels ) {
-            *++it = uint8_t( qBound( 0, ch2 * gain2 + binaryOffset, 0xFF ) ); // clip ..
-            ++received;
-        }
-        if ( ( block += channels ) >= packetLength ) {
-            ++packet;
-            block = 0;
-            hdc->raw.received = received;
+    while ( received < rawSamplesize ) {
+        const unsigned chunk = qMin( packetLength, rawSamplesize - received ) / channels * channels;
+        if ( !chunk )
+            break;
+        hdc->demoGenerator.generate( dp->data() + received, chunk / channels, channels, samplerate, gainValue, ac );
+        received += chunk;
+        hdc->rollRaw.received = received;
+        if ( chunk == packetLength && !hdc->scopeDevice->isUnthrottled() ) // simulate the USB transfer time
             QThread::usleep( unsigned( 1e6 * packetLength / channels / samplerate ) );
-            if ( !hdc->capturing || hdc->scopeDevice->hasStopped() )
-                break;
-        }
+        if ( !hdc->capturing || hdc->scopeDevice->hasStopped() )
+            break;
     }
     // timestampDebug( QString( "Received dummy packet %1: %2 bytes" ).arg( packet ).arg( rawSamplesize ) );
     return received;
 }
+
+
+unsigned CapturingThread::getPlaybackSamples() {
+    const unsigned char *data = nullptr;
+    const RawBlockHeader *block = hdc->scopeDevice->getPlayer()->nextBlock( data );
+    hdc->rollRaw.received = 0;
+    if ( !block ) { // empty recording
+        QThread::msleep( 100 );
+        return 0;
+    }
+    // replay the block with its recorded settings
+    channels = block->channels;
+    samplerate = block->samplerate;
+    oversampling = block->oversampling;
+    gainValue[ 0 ] = block->gainValue[ 0 ];
+    gainValue[ 1 ] = block->gainValue[ 1 ];
+    gainIndex[ 0 ] = block->gainIndex[ 0 ];
+    gainIndex[ 1 ] = block->gainIndex[ 1 ];
+    if ( !hdc->scopeDevice->isUnthrottled() ) {
+        // real time: keep the recorded distance to the previous block
+        int64_t delay = block->time - playbackTime;
+        if ( delay < 0 || delay > int64_t( 10e9 ) ) // 1st block, replay restarted or long pause
+            delay = int64_t( 1e9 * block->size / qMax( channels, 1U ) / qMax( samplerate, 1.0 ) );
+        while ( playbackTimer.isValid() && playbackTimer.nsecsElapsed() < delay ) {
+            QThread::usleep( unsigned( qMin( ( delay - playbackTimer.nsecsElapsed() ) / 1000, int64_t( 10000 ) ) ) );
+            if ( !hdc->capturing || hdc->scopeDevice->hasStopped() )
+                return 0;
+        }
+        playbackTimer.start();
+        playbackTime = block->time;
+    }
+    if ( !block->size ) // gap in the recording
+        return 0;
+    rawSamplesize = block->size;
+    dp->assign( data, data + block->size );
+    hdc->rollRaw.received = block->size;
+    return block->size;
+}
@@ -4,6 +4,8 @@
 
 #include "hantekdsocontrol.h"
 
+#include <QElapsedTimer>
+
 class CapturingThread : public QThread {
     Q_OBJECT
 
@@ -16,7 +18,10 @@ class CapturingThread : public QThread {
     void capture();
     unsigned getRealSamples();
     unsigned getDemoSamples();
+    unsigned getPlaybackSamples();
+    void fillBlock( Raw *raw );
     void xferSamples();
+    void recordSamples();
     HantekDsoControl *hdc;
     unsigned channels = 0;
     double effectiveSamplerate = 0;
@@ -28,8 +33,13 @@ class CapturingThread : public QThread {
     unsigned gainValue[ 2 ] = { 0, 0 }; // 1,2,5,10,..
     unsigned gainIndex[ 2 ] = { 0, 0 }; // index 0..7
     unsigned tag = 0;
+    int64_t timeStart = 0; // steady clock time of the transfer start in ns
+    int64_t timeEnd = 0;   // steady clock time of the transfer end in ns
+    unsigned streamOverruns = 0; // last reported number of stream overruns
     bool valid = true;
     bool freeRun = false;
-    std::vector< unsigned char > data;
-    std::vector< unsigned char > *dp = &data;
+    QElapsedTimer playbackTimer; // real time playback: time since the last block
+    int64_t playbackTime = 0;    // real time playback: recorded time of the last block
+    Raw *segment = nullptr;                     // sequence mode: the segment of hdc->segmentPool that is filled
+    std::vector< unsigned char > *dp = nullptr; // target of the sampling, a block of hdc->rawQueue, segment or hdc->rollRaw
 };
@@ -31,13 +31,20 @@ struct ControlSettingsSamplerate {
 
 /// \brief Stores the current trigger settings of the device.
 struct ControlSettingsTrigger {
-    std::vector< double > level;                    ///< The trigger level for each channel in V
-    double position = 0.0;                          ///< The current pretrigger position
-    unsigned int point = 0;                         ///< The trigger position in Hantek coding
-    Dso::TriggerMode mode = Dso::TriggerMode::AUTO; ///< The trigger mode
-    Dso::Slope slope = Dso::Slope::Positive;        ///< The trigger slope
-    int source = 0;                                 ///< The trigger source
-    int smooth = 0;                                 ///< Don't trigger on glitches
+    std::vector< double > level;                                      ///< The trigger level for each channel in V
+    double position = 0.0;                                            ///< The current pretrigger position
+    unsigned int point = 0;                                           ///< The trigger position in Hantek coding
+    Dso::TriggerMode mode = Dso::TriggerMode::AUTO;                   ///< The trigger mode
+    Dso::Slope slope = Dso::Slope::Positive;                          ///< The trigger slope
+    int source = 0;                                                   ///< The trigger source
+    int smooth = 0;                                                   ///< Don't trigger on glitches
+    Dso::TriggerType type = Dso::TriggerType::Edge;                   ///< The event that causes a trigger
+    Dso::TriggerCondition condition = Dso::TriggerCondition::Greater; ///< Time condition for pulse width and slew rate
+    double time1 = 1e-3;                                              ///< Pulse width, slew rate or timeout time (s)
+    double time2 = 2e-3;                                              ///< Upper time limit of the condition "within" (s)
+    double height = 0.5;                                              ///< Runt, window, slew rate: 2nd level = level + height
+    double hysteresis = 0.0;                                          ///< Noise rejection of the trigger level (V)
+    bool multiTrigger = false;                                        ///< Provide the positions of all events of a block
 };
 
 /// \brief Stores the current amplification settings of the device.
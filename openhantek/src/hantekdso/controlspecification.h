@@ -22,6 +22,8 @@ struct ControlSamplerateLimits {
 struct ControlSpecificationSamplerate {
     ControlSamplerateLimits single = { 50e6, 50e6, std::vector< unsigned >() };  ///< The limits for single channel mode
     ControlSamplerateLimits multi = { 100e6, 100e6, std::vector< unsigned >() }; ///< The limits for multi channel mode
+    double singleStreamingMax = 0;                                                ///< Single channel limit when streaming
+    double multiStreamingMax = 0;                                                 ///< Multi channel limit when streaming
 };
 
 struct ControlSpecificationGainLevel {
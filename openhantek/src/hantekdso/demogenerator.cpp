@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "demogenerator.h"
+
+#include <QMutexLocker>
+#include <QStringList>
+#include <QVector>
+#include <cmath>
+
+
+DemoGenerator::DemoGenerator() {
+    for ( unsigned iii = 0; iii < TABLE_SIZE; ++iii )
+        sineTable[ iii ] = float( sin( 2 * M_PI * iii / TABLE_SIZE ) );
+    // the legacy demo signals: CH1 2 V falling sawtooth with 1 kHz, CH2 1 V square wave with 500 Hz (0..2 V if DC)
+    channel[ 0 ].waveform = SAWTOOTH;
+    channel[ 0 ].amplitude = 2;
+    channel[ 1 ].waveform = SQUARE;
+    channel[ 1 ].frequency = 500;
+    channel[ 1 ].offset = 1;
+    pendingChannel[ 0 ] = channel[ 0 ];
+    pendingChannel[ 1 ] = channel[ 1 ];
+}
+
+
+bool DemoGenerator::configure( const QString &command ) {
+    static const QStringList waveforms = { "sawtooth", "sine", "square", "pulse", "noise", "am", "fm" };
+    QStringList parts = command.simplified().split( ' ' );
+    if ( parts.isEmpty() )
+        return false;
+    QVector< double > values;
+    for ( int iii = 1 + ( parts[ 0 ] == "1" || parts[ 0 ] == "2" ); iii < parts.size(); ++iii ) {
+        bool ok;
+        values.append( parts[ iii ].toDouble( &ok ) );
+        if ( !ok )
+            return false;
+    }
+    QMutexLocker locker( &configMutex );
+    if ( parts[ 0 ] == "1" || parts[ 0 ] == "2" ) {
+        if ( parts.size() < 2 || !waveforms.contains( parts[ 1 ] ) )
+            return false;
+        Channel &ch = pendingChannel[ parts[ 0 ].toUInt() - 1 ];
+        ch.waveform = Waveform( waveforms.indexOf( parts[ 1 ] ) );
+        double *targets[] = { &ch.frequency, &ch.amplitude, &ch.offset, &ch.parameter };
+        for ( int iii = 0; iii < values.size() && iii < 4; ++iii )
+            *targets[ iii ] = values[ iii ];
+    } else if ( parts[ 0 ] == "glitch" && values.size() >= 1 ) {
+        pendingGlitchRate = values[ 0 ];
+        if ( values.size() >= 2 )
+            pendingGlitchAmplitude = values[ 1 ];
+    } else if ( parts[ 0 ] == "slowdown" && values.size() == 1 ) {
+        pendingSlowdown = values[ 0 ] != 0;
+    } else if ( parts[ 0 ] == "seed" && values.size() == 1 ) {
+        pendingSeed = uint32_t( values[ 0 ] ) ? uint32_t( values[ 0 ] ) : 1; // xorshift needs a state != 0
+        reseed = true;
+    } else {
+        return false;
+    }
+    configChanged.store( true, std::memory_order_release );
+    return true;
+}
+
+
+void DemoGenerator::applyPending() {
+    QMutexLocker locker( &configMutex );
+    channel[ 0 ] = pendingChannel[ 0 ];
+    channel[ 1 ] = pendingChannel[ 1 ];
+    glitchRate = pendingGlitchRate;
+    glitchAmplitude = pendingGlitchAmplitude;
+    slowdown = pendingSlowdown;
+    if ( reseed ) {
+        random = pendingSeed;
+        glitchCountdown = 0;
+        reseed = false;
+    }
+    configChanged.store( false, std::memory_order_relaxed );
+}
+
+
+void DemoGenerator::generateChannel( unsigned ch, float *out, unsigned samples, double samplerate ) {
+    const Channel &c = channel[ ch ];
+    double frequency = c.frequency;
+    if ( slowdown && samplerate < 10e6 ) // keep the look of the legacy demo for all timebases
+        frequency *= samplerate / 10e6;
+    const uint32_t increment = uint32_t( fmod( frequency / samplerate, 1.0 ) * 4294967296.0 );
+    const uint32_t modulationIncrement = increment / 10; // AM, FM: modulation with 1/10 of the carrier frequency
+    const float amplitude = float( c.amplitude );
+    const float parameter = float( c.parameter );
+    uint32_t p = phase[ ch ];
+    uint32_t m = modulationPhase[ ch ];
+    switch ( c.waveform ) {
+    case SAWTOOTH: // falling from +amplitude to -amplitude
+        for ( unsigned iii = 0; iii < samples; ++iii, p += increment )
+            out[ iii ] = amplitude * ( 1.0f - float( p ) * float( 1.0 / 2147483648.0 ) );
+        break;
+    case SINE:
+        for ( unsigned iii = 0; iii < samples; ++iii, p += increment )
+            out[ iii ] = amplitude * sineTable[ p >> PHASE_SHIFT ];
+        break;
+    case SQUARE:
+        for ( unsigned iii = 0; iii < samples; ++iii, p += increment )
+            out[ iii ] = p < 0x80000000u ? amplitude : -amplitude;
+        break;
+    case PULSE: { // high for the duty cycle part of the period
+        const uint32_t high = uint32_t( qBound( 0.0, c.parameter, 1.0 ) * 4294967295.0 );
+        for ( unsigned iii = 0; iii < samples; ++iii, p += increment )
+            out[ iii ] = p < high ? amplitude : 0.0f;
+        break;
+    }
+    case NOISE: // uniform white noise
+        for ( unsigned iii = 0; iii < samples; ++iii )
+            out[ iii ] = amplitude * ( float( nextRandom() ) * float( 1.0 / 2147483648.0 ) - 1.0f );
+        break;
+    case AM: { // peak value stays at amplitude
+        const float depth = qBound( 0.0f, parameter, 1.0f );
+        const float scale = amplitude / ( 1.0f + depth );
+        for ( unsigned iii = 0; iii < samples; ++iii, p += increment, m += modulationIncrement )
+            out[ iii ] = scale * sineTable[ p >> PHASE_SHIFT ] * ( 1.0f + depth * sineTable[ m >> PHASE_SHIFT ] );
+        break;
+    }
+    case FM: {
+        const float deviation = float( increment ) * qBound( 0.0f, parameter, 1.0f );
+        for ( unsigned iii = 0; iii < samples; ++iii, m += modulationIncrement ) {
+            out[ iii ] = amplitude * sineTable[ p >> PHASE_SHIFT ];
+            // unsigned modulo 2^32 arithmetic, the deviation can exceed the int32 range above samplerate / 2
+            p += increment + uint32_t( int64_t( deviation * sineTable[ m >> PHASE_SHIFT ] ) );
+        }
+        break;
+    }
+    }
+    phase[ ch ] = p;
+    modulationPhase[ ch ] = m;
+}
+
+
+void DemoGenerator::generate( unsigned char *data, unsigned samples, unsigned channels, double samplerate,
+                              const unsigned gain[ 2 ], const bool ac[ 2 ] ) {
+    if ( configChanged.load( std::memory_order_acquire ) )
+        applyPending();
+    if ( samplerate <= 0 || !samples )
+        return;
+    channels = qBound( 1u, channels, 2u );
+    for ( unsigned ch = 0; ch < channels; ++ch ) {
+        work[ ch ].resize( samples );
+        generateChannel( ch, work[ ch ].data(), samples, samplerate );
+    }
+    if ( glitchRate > 0 ) { // single sample spikes in random distances around samplerate / glitchRate
+        const double distance = samplerate / glitchRate;
+        double pos = glitchCountdown;
+        for ( ; pos < samples; pos += distance * ( 0.5 + nextRandom() / 4294967296.0 ) )
+            for ( unsigned ch = 0; ch < channels; ++ch )
+                work[ ch ][ unsigned( pos ) ] += float( glitchAmplitude );
+        glitchCountdown = pos - samples; // continue in the next chunk
+    }
+    // convert into the 8 bit binary offset ADC format
+    for ( unsigned ch = 0; ch < channels; ++ch ) {
+        const float scale = float( ADC_PER_VOLT * gain[ ch ] );
+        const float offset = float( ( ac[ ch ] ? 0.0 : channel[ ch ].offset ) * ADC_PER_VOLT * gain[ ch ] + 0x80 );
+        const float *in = work[ ch ].data();
+        unsigned char *out = data + ch;
+        for ( unsigned iii = 0; iii < samples; ++iii, out += channels )
+            *out = uint8_t( qBound( 0.0f, in[ iii ] * scale + offset + 0.5f, 255.0f ) ); // clip if outside 8bit range
+    }
+}
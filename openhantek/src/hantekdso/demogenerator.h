@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+
+/// \brief Table driven (DDS) signal synthesizer for the demo device.
+///
+/// Each channel has its own waveform, frequency, amplitude and offset, the signal is continuous across blocks.
+/// The samples are generated as float in a tight loop per channel and converted in a second loop into the interleaved
+/// 8 bit binary offset ADC format, both loops can be vectorized by the compiler.
+/// The noise and glitch generators use a fixed seed, i.e. the sequence is reproducible from program start.
+///
+/// Configuration (e.g. via HantekDsoControl::stringCommand() "demo ..." or the command line option "--demoSignal"):
+/// <pre>
+///   <channel> <waveform> [<frequency> [<amplitude> [<offset> [<parameter>]]]]
+///     channel:   1 or 2
+///     waveform:  sawtooth, sine, square, pulse, noise, am, fm
+///     frequency: Hz, amplitude and offset: V
+///     parameter: pulse: duty cycle (0..1), am: modulation depth (0..1), fm: frequency deviation (0..1)
+///   glitch <rate> [<amplitude>]  inject a one sample spike <rate> times per second into both channels
+///   slowdown <0|1>               scale the frequencies down for samplerates < 10 MS/s (default 1, as the legacy demo)
+///   seed <n>                     restart the noise and glitch generator
+/// </pre>
+class DemoGenerator {
+  public:
+    enum Waveform { SAWTOOTH, SINE, SQUARE, PULSE, NOISE, AM, FM };
+
+    struct Channel {
+        Waveform waveform = SINE;
+        double frequency = 1000;
+        double amplitude = 1;
+        double offset = 0;
+        double parameter = 0.5;
+    };
+
+    DemoGenerator();
+
+    /// \brief Parse one configuration command (thread safe), it is applied with the next generated chunk.
+    /// \return false if the command is invalid.
+    bool configure( const QString &command );
+
+    /// \brief Generate the next samples of the continuous signal.
+    /// \param data Target, interleaved if channels == 2.
+    /// \param samples Number of samples per channel.
+    /// \param channels Number of channels (1 or 2).
+    /// \param samplerate The raw samplerate of the ADC.
+    /// \param gain The gain value of the channels (1, 2, 5, 10).
+    /// \param ac AC coupling of the channels, the offset is suppressed.
+    void generate( unsigned char *data, unsigned samples, unsigned channels, double samplerate, const unsigned gain[ 2 ],
+                   const bool ac[ 2 ] );
+
+  private:
+    static const unsigned TABLE_BITS = 12;
+    static const unsigned TABLE_SIZE = 1 << TABLE_BITS;
+    static const unsigned PHASE_SHIFT = 32 - TABLE_BITS; // phase accumulator -> table index
+    static constexpr double ADC_PER_VOLT = 25;           // ADC steps per V at gain 1
+    float sineTable[ TABLE_SIZE ];
+
+    void applyPending();
+    uint32_t nextRandom() {
+        random ^= random << 13; // xorshift32
+        random ^= random >> 17;
+        random ^= random << 5;
+        return random;
+    }
+    void generateChannel( unsigned channel, float *out, unsigned samples, double samplerate );
+
+    Channel channel[ 2 ];
+    double glitchRate = 0;
+    double glitchAmplitude = 2;
+    bool slowdown = true;
+
+    uint32_t phase[ 2 ] = { 0, 0 };           // carrier phase
+    uint32_t modulationPhase[ 2 ] = { 0, 0 }; // am / fm phase
+    uint32_t random = 0x12345678;             // noise state
+    double glitchCountdown = 0;               // samples until the next glitch
+    std::vector< float > work[ 2 ];           // generated samples in V
+
+    // configuration changes from another thread
+    QMutex configMutex;
+    std::atomic< bool > configChanged{ false };
+    Channel pendingChannel[ 2 ];
+    double pendingGlitchRate = 0;
+    double pendingGlitchAmplitude = 2;
+    bool pendingSlowdown = true;
+    uint32_t pendingSeed = 0x12345678;
+    bool reseed = false;
+};
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "hantekprotocol/types.h"
+#include "samplestatistics.h"
 #include "utils/printutils.h"
 #include <QReadLocker>
 #include <QReadWriteLock>
@@ -9,16 +11,21 @@
 #include <vector>
 
 struct DSOsamples {
-    std::vector< std::vector< double > > data; ///< Pointer to input data from device
-    double samplerate = 0.0;                   ///< The samplerate of the input data
-    unsigned char clipped = 0;                 ///< Bitmask of clipped channels
-    bool liveTrigger = false;                  ///< live samples are triggered
-    int triggeredPosition = 0;                 ///< position for a triggered trace, 0 = not triggered
-    double pulseWidth1 = 0.0;                  ///< width from trigger point to next opposite slope
-    double pulseWidth2 = 0.0;                  ///< width from next opposite slope to third slope
-    Unit mathVoltageUnit = UNIT_VOLTS;         ///< unless UNIT_VOLTSQUARE for some math functions
-    bool freeRunning = false;                  ///< trigger: NONE, half sample count
-    unsigned tag = 0;                          ///< track individual sample blocks (debug support)
+    std::vector< std::vector< Sample > > data;  ///< Pointer to input data from device
+    std::vector< SampleStatistics > statistics; ///< Statistics of the data, calculated during conversion
+    double samplerate = 0.0;                    ///< The samplerate of the input data
+    unsigned char clipped = 0;                  ///< Bitmask of clipped channels
+    bool liveTrigger = false;                   ///< live samples are triggered
+    int triggeredPosition = 0;                  ///< position for a triggered trace, 0 = not triggered
+    double triggerOffset = 0.0;                 ///< exact crossing at triggeredPosition - triggerOffset, [0, 1)
+    std::vector< double > triggerEvents;        ///< multi trigger: exact sample times of all trigger events
+    double pulseWidth1 = 0.0;                   ///< width from trigger point to next opposite slope
+    double pulseWidth2 = 0.0;                   ///< width from next opposite slope to third slope
+    Unit mathVoltageUnit = UNIT_VOLTS;          ///< unless UNIT_VOLTSQUARE for some math functions
+    bool freeRunning = false;                   ///< trigger: NONE, half sample count
+    unsigned tag = 0;                           ///< track individual sample blocks (debug support)
+    int64_t timeStart = 0;                      ///< steady clock time of the block's transfer start in ns
+    int64_t timeEnd = 0;                        ///< steady clock time of the block's transfer end in ns
     mutable QReadWriteLock lock;
 };
 
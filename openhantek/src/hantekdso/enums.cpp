@@ -6,6 +6,8 @@
 namespace Dso {
 Enum< Dso::TriggerMode, Dso::TriggerMode::AUTO, Dso::TriggerMode::ROLL > TriggerModeEnum;
 Enum< Dso::Slope, Dso::Slope::Positive, Dso::Slope::Both > SlopeEnum;
+Enum< Dso::TriggerType, Dso::TriggerType::Edge, Dso::TriggerType::Timeout > TriggerTypeEnum;
+Enum< Dso::TriggerCondition, Dso::TriggerCondition::Less, Dso::TriggerCondition::Within > TriggerConditionEnum;
 Enum< Dso::GraphFormat, Dso::GraphFormat::TY, Dso::GraphFormat::XY > GraphFormatEnum;
 
 /// \brief Return string representation of the given graph format.
@@ -78,4 +80,42 @@ QString slopeString( Slope slope ) {
     return QString();
 }
 
+
+/// \brief Return string representation of the given trigger type.
+/// \param type The ::TriggerType that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString triggerTypeString( TriggerType type ) {
+    switch ( type ) {
+    case TriggerType::Edge:
+        return QCoreApplication::tr( "Edge" );
+    case TriggerType::PulseWidth:
+        return QCoreApplication::tr( "Pulse width" );
+    case TriggerType::Runt:
+        return QCoreApplication::tr( "Runt" );
+    case TriggerType::WindowEnter:
+        return QCoreApplication::tr( "Window enter" );
+    case TriggerType::WindowExit:
+        return QCoreApplication::tr( "Window exit" );
+    case TriggerType::SlewRate:
+        return QCoreApplication::tr( "Slew rate" );
+    case TriggerType::Timeout:
+        return QCoreApplication::tr( "Timeout" );
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given trigger time condition.
+/// \param condition The ::TriggerCondition that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString triggerConditionString( TriggerCondition condition ) {
+    switch ( condition ) {
+    case TriggerCondition::Less:
+        return QString::fromUtf8( "<" );
+    case TriggerCondition::Greater:
+        return QString::fromUtf8( ">" );
+    case TriggerCondition::Within:
+        return QString::fromUtf8( "<>" );
+    }
+    return QString();
+}
 } // namespace Dso
@@ -49,6 +49,28 @@ enum class Slope : uint8_t {
 };
 extern Enum< Dso::Slope, Dso::Slope::Positive, Dso::Slope::Both > SlopeEnum;
 
+/// \enum TriggerType
+/// \brief The event that causes a (software) trigger, the slope selects the polarity.
+enum class TriggerType : uint8_t {
+    Edge,        ///< Level crossing, with hysteresis
+    PulseWidth,  ///< Pulse between two level crossings, width checked with the time condition
+    Runt,        ///< Pulse that crosses the level but not the level + height
+    WindowEnter, ///< Signal enters the window [level, level + height]
+    WindowExit,  ///< Signal leaves the window [level, level + height]
+    SlewRate,    ///< Transition from level to level + height, time checked with the time condition
+    Timeout      ///< No further level crossing for longer than time 1 (dropout)
+};
+extern Enum< Dso::TriggerType, Dso::TriggerType::Edge, Dso::TriggerType::Timeout > TriggerTypeEnum;
+
+/// \enum TriggerCondition
+/// \brief The time condition of the pulse width and slew rate trigger.
+enum class TriggerCondition : uint8_t {
+    Less,    ///< Shorter than time 1
+    Greater, ///< Longer than time 1
+    Within   ///< Between time 1 and time 2
+};
+extern Enum< Dso::TriggerCondition, Dso::TriggerCondition::Less, Dso::TriggerCondition::Within > TriggerConditionEnum;
+
 /// \enum InterpolationMode
 /// \brief The different interpolation modes for the graphs.
 enum InterpolationMode {
@@ -72,11 +94,15 @@ QString graphFormatString( GraphFormat format );
 QString couplingString( Coupling coupling );
 QString triggerModeString( TriggerMode mode );
 QString slopeString( Slope slope );
+QString triggerTypeString( TriggerType type );
+QString triggerConditionString( TriggerCondition condition );
 // QString interpolationModeString(InterpolationMode interpolation);
 } // namespace Dso
 
 Q_DECLARE_METATYPE( Dso::TriggerMode )
 Q_DECLARE_METATYPE( Dso::Slope )
+Q_DECLARE_METATYPE( Dso::TriggerType )
+Q_DECLARE_METATYPE( Dso::TriggerCondition )
 Q_DECLARE_METATYPE( Dso::Coupling )
 Q_DECLARE_METATYPE( Dso::GraphFormat )
 Q_DECLARE_METATYPE( Dso::ChannelMode )
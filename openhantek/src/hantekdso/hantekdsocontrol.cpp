@@ -6,10 +6,13 @@
 #include <QTimer>
 
 #include <QtCore>
+#include <algorithm>
 
 #include "hantekdsocontrol.h"
 #include "hantekprotocol/controlStructs.h"
 #include "mathchannel.h"
+#include "rawkernel.h"
+#include "rawplayer.h"
 #include "scopesettings.h"
 #include "usb/scopedevice.h"
 
@@ -22,7 +25,8 @@ HantekDsoControl::HantekDsoControl( ScopeDevice *device, const DSOModel *model,
       controlsettings( &( specification->samplerate.single ), specification->channels ) {
 
     if ( verboseLevel > 1 )
-        qDebug() << " HantekDsoControl::HantekDsoControl()";
+        qDebug() << " HantekDsoControl::HantekDsoControl()" << RawKernel::kernelName() << "raw data kernel,"
+                 << workerPool.threadCount() << "conversion threads";
     qRegisterMetaType< DSOsamples * >();
     qRegisterMetaType< QList< double > >();
 
@@ -56,6 +60,66 @@ void HantekDsoControl::prepareForShutdown() {
 }
 
 
+bool HantekDsoControl::startRecording( const QString &fileName, unsigned maxSegments ) {
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::startRecording()" << fileName << maxSegments;
+    CalibrationValues correction;
+    correctionToBytes( correction );
+    if ( !rawRecorder.start( fileName, model->name, *controlsettings.calibrationValues, correction, maxSegments ) ) {
+        emit statusMessage( tr( "Cannot record into %1: %2" ).arg( fileName, rawRecorder.getErrorString() ), 0 );
+        return false;
+    }
+    emit statusMessage( tr( "Recording raw samples into %1" ).arg( fileName ), 0 );
+    return true;
+}
+
+
+void HantekDsoControl::stopRecording() {
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::stopRecording()" << rawRecorder.getBytesWritten();
+    if ( !rawRecorder.isRecording() )
+        return;
+    rawRecorder.stop();
+    double megaBytes = double( rawRecorder.getBytesWritten() ) / 1e6;
+    emit statusMessage( tr( "Recording stopped, %1 MB written" ).arg( megaBytes, 0, 'f', 1 ), 0 );
+}
+
+
+void HantekDsoControl::startSequence( unsigned count ) {
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::startSequence()" << count;
+    if ( triggerModeNONE() ) {
+        emit statusMessage( tr( "Sequence capture is not possible in roll mode" ), 3000 );
+        return;
+    }
+    segmentPool.request( count );
+    sequenceRunning = true;
+    segmentIndex = 0;
+    emit statusMessage( tr( "Capturing a sequence of %1 blocks .." ).arg( count ), 0 );
+    enableSamplingUI( true );
+}
+
+
+void HantekDsoControl::stopSequence() {
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::stopSequence()" << segmentPool.getFilled();
+    if ( sequenceRunning )
+        segmentPool.cancel(); // the state machine shows the segments captured so far
+}
+
+
+void HantekDsoControl::showSegment( int index ) {
+    if ( verboseLevel > 3 )
+        qDebug() << "   HDC::showSegment()" << index;
+    const unsigned count = getSegmentCount();
+    if ( !count || sequenceRunning )
+        return;
+    segmentIndex = unsigned( qBound( 0, index, int( count ) - 1 ) );
+    emit statusMessage( tr( "Segment %1 / %2" ).arg( segmentIndex + 1 ).arg( count ), 0 );
+    requestRefresh(); // convert and trigger the new segment
+}
+
+
 bool HantekDsoControl::deviceNotConnected() { return !scopeDevice->isConnected(); }
 
 
@@ -69,9 +133,21 @@ void HantekDsoControl::restoreTargets() {
 }
 
 
+double HantekDsoControl::getSamplerateLimit() const {
+    double limit = isSingleChannel() ? specification->samplerate.single.max : specification->samplerate.multi.max;
+    if ( scopeDevice && scopeDevice->isStreamingMode() ) { // continuous streaming allows higher sample rates
+        if ( isSingleChannel() )
+            limit = qMax( limit, specification->samplerate.singleStreamingMax );
+        else
+            limit = qMax( limit, specification->samplerate.multiStreamingMax );
+    }
+    return limit;
+}
+
+
 void HantekDsoControl::updateSamplerateLimits() {
     QList< double > sampleSteps;
-    double limit = isSingleChannel() ? specification->samplerate.single.max : specification->samplerate.multi.max;
+    double limit = getSamplerateLimit();
 
     if ( controlsettings.samplerate.current > limit ) {
         setSamplerate( limit );
@@ -90,17 +166,16 @@ void HantekDsoControl::updateSamplerateLimits() {
 
 
 void HantekDsoControl::controlSetSamplerate( uint8_t sampleIndex ) {
-    static uint8_t lastIndex = 0xFF;
     uint8_t id = specification->fixedSampleRates[ sampleIndex ].id;
     if ( verboseLevel > 2 )
         qDebug() << "  HDC::controlSetSamplerate()" << sampleIndex << "id:" << id;
     if ( verboseLevel > 3 )
         qDebug() << "   ThreadID:" << QThread::currentThreadId();
     modifyCommand< ControlSetSamplerate >( ControlCode::CONTROL_SETSAMPLERATE )->setSamplerate( id, sampleIndex );
-    if ( sampleIndex != lastIndex ) { // samplerate has changed, start new sampling
+    if ( sampleIndex != lastSampleIndex ) { // samplerate has changed, start new sampling
         restartSampling();
     }
-    lastIndex = sampleIndex;
+    lastSampleIndex = sampleIndex;
 }
 
 
@@ -149,11 +224,7 @@ Dso::ErrorCode HantekDsoControl::setRecordTime( double duration ) {
     if ( verboseLevel > 2 )
         qDebug() << "  duration =" << duration;
 
-    double srLimit;
-    if ( isSingleChannel() )
-        srLimit = ( specification->samplerate.single ).max;
-    else
-        srLimit = ( specification->samplerate.multi ).max;
+    double srLimit = getSamplerateLimit();
     // For now - we go for the SAMPLESIZE (= 20000) size sampling, defined in dsosamples.h
     // Find highest samplerate using less equal half of these samples to obtain our duration.
     uint8_t sampleIndex = 0;
@@ -255,7 +326,6 @@ Dso::ErrorCode HantekDsoControl::setGain( ChannelID channel, double gain ) {
 
     if ( verboseLevel > 2 )
         qDebug() << "  HDC::setGain()" << channel << gain;
-    static uint8_t lastGain[ 2 ] = { 0xFF, 0xFF };
     gain /= controlsettings.voltage[ channel ].probeAttn; // gain needs to be scaled by probe attenuation
     // Find lowest gain voltage that's at least as high as the requested
     uint8_t gainID;
@@ -302,7 +372,6 @@ Dso::ErrorCode HantekDsoControl::setCoupling( ChannelID channel, Dso::Coupling c
     if ( channel >= specification->channels )
         return Dso::ErrorCode::PARAMETER;
 
-    static int lastCoupling[ 2 ] = { -1, -1 };
     if ( verboseLevel > 2 )
         qDebug() << "  HDC::setCoupling()" << channel << int( coupling );
     if ( hasCommand( ControlCode::CONTROL_SETCOUPLING ) ) // don't send command if it is not implemented (like on the 6022)
@@ -323,17 +392,15 @@ Dso::ErrorCode HantekDsoControl::setTriggerMode( Dso::TriggerMode mode ) {
 
     if ( verboseLevel > 2 )
         qDebug() << "  HDC::setTriggerMode()" << int( mode );
-    static Dso::TriggerMode lastMode;
     controlsettings.trigger.mode = mode;
     if ( Dso::TriggerMode::SINGLE != mode )
         enableSamplingUI();
     // trigger mode changed NONE <-> !NONE
-    if ( ( Dso::TriggerMode::ROLL == mode && Dso::TriggerMode::ROLL != lastMode ) ||
-         ( Dso::TriggerMode::ROLL != mode && Dso::TriggerMode::ROLL == lastMode ) ) {
+    if ( ( Dso::TriggerMode::ROLL == mode && Dso::TriggerMode::ROLL != lastTriggerMode ) ||
+         ( Dso::TriggerMode::ROLL != mode && Dso::TriggerMode::ROLL == lastTriggerMode ) ) {
         restartSampling(); // invalidate old samples
-        raw.freeRun = Dso::TriggerMode::ROLL == mode;
     }
-    lastMode = mode;
+    lastTriggerMode = mode;
     requestRefresh();
     return Dso::ErrorCode::NONE;
 }
@@ -361,6 +428,83 @@ Dso::ErrorCode HantekDsoControl::setTriggerSmooth( int smooth ) {
 }
 
 
+Dso::ErrorCode HantekDsoControl::setTriggerType( Dso::TriggerType type ) {
+    if ( deviceNotConnected() )
+        return Dso::ErrorCode::CONNECTION;
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::setTriggerType()" << int( type );
+    controlsettings.trigger.type = type;
+    requestRefresh();
+    return Dso::ErrorCode::NONE;
+}
+
+
+Dso::ErrorCode HantekDsoControl::setTriggerCondition( Dso::TriggerCondition condition ) {
+    if ( deviceNotConnected() )
+        return Dso::ErrorCode::CONNECTION;
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::setTriggerCondition()" << int( condition );
+    controlsettings.trigger.condition = condition;
+    requestRefresh();
+    return Dso::ErrorCode::NONE;
+}
+
+
+Dso::ErrorCode HantekDsoControl::setTriggerTime1( double time ) {
+    if ( deviceNotConnected() )
+        return Dso::ErrorCode::CONNECTION;
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::setTriggerTime1()" << time;
+    controlsettings.trigger.time1 = time;
+    requestRefresh();
+    return Dso::ErrorCode::NONE;
+}
+
+
+Dso::ErrorCode HantekDsoControl::setTriggerTime2( double time ) {
+    if ( deviceNotConnected() )
+        return Dso::ErrorCode::CONNECTION;
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::setTriggerTime2()" << time;
+    controlsettings.trigger.time2 = time;
+    requestRefresh();
+    return Dso::ErrorCode::NONE;
+}
+
+
+Dso::ErrorCode HantekDsoControl::setTriggerHeight( double height ) {
+    if ( deviceNotConnected() )
+        return Dso::ErrorCode::CONNECTION;
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::setTriggerHeight()" << height;
+    controlsettings.trigger.height = height;
+    requestRefresh();
+    return Dso::ErrorCode::NONE;
+}
+
+
+Dso::ErrorCode HantekDsoControl::setTriggerHysteresis( double hysteresis ) {
+    if ( deviceNotConnected() )
+        return Dso::ErrorCode::CONNECTION;
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::setTriggerHysteresis()" << hysteresis;
+    controlsettings.trigger.hysteresis = hysteresis;
+    requestRefresh();
+    return Dso::ErrorCode::NONE;
+}
+
+
+Dso::ErrorCode HantekDsoControl::setTriggerMulti( bool multi ) {
+    if ( deviceNotConnected() )
+        return Dso::ErrorCode::CONNECTION;
+    if ( verboseLevel > 2 )
+        qDebug() << "  HDC::setTriggerMulti()" << multi;
+    controlsettings.trigger.multiTrigger = multi;
+    requestRefresh();
+    return Dso::ErrorCode::NONE;
+}
+
+
 // trigger level in Volt
 Dso::ErrorCode HantekDsoControl::setTriggerLevel( ChannelID channel, double level ) {
     if ( deviceNotConnected() )
@@ -404,6 +548,7 @@ void HantekDsoControl::applySettings( DsoSettingsScope *dsoSettingsScope ) {
     if ( verboseLevel > 1 )
         qDebug() << " HDC::applySettings()";
     scope = dsoSettingsScope;
+    beginCommandBatch(); // send all changed settings together
     bool mathUsed = dsoSettingsScope->anyUsed( specification->channels );
     for ( ChannelID channel = 0; channel <= specification->channels; ++channel ) {
         setProbe( channel, dsoSettingsScope->voltage[ channel ].probeAttn );
@@ -422,6 +567,14 @@ void HantekDsoControl::applySettings( DsoSettingsScope *dsoSettingsScope ) {
     setTriggerSlope( dsoSettingsScope->trigger.slope );
     setTriggerSource( dsoSettingsScope->trigger.source );
     setTriggerSmooth( dsoSettingsScope->trigger.smooth );
+    setTriggerType( dsoSettingsScope->trigger.type );
+    setTriggerCondition( dsoSettingsScope->trigger.condition );
+    setTriggerTime1( dsoSettingsScope->trigger.time1 );
+    setTriggerTime2( dsoSettingsScope->trigger.time2 );
+    setTriggerHeight( dsoSettingsScope->trigger.height );
+    setTriggerHysteresis( dsoSettingsScope->trigger.hysteresis );
+    setTriggerMulti( dsoSettingsScope->trigger.multiTrigger );
+    endCommandBatch();
     mathChannel = std::unique_ptr< MathChannel >( new MathChannel( scope ) );
     triggering = std::unique_ptr< Triggering >( new Triggering( scope, controlsettings ) );
 }
@@ -432,7 +585,7 @@ void HantekDsoControl::restartSampling() {
     if ( verboseLevel > 4 )
         qDebug() << "    HDC::restartSampling()";
     scopeDevice->stopSampling();
-    raw.rollMode = false;
+    rollRaw.rollMode = false;
 }
 
 
@@ -440,6 +593,10 @@ void HantekDsoControl::restartSampling() {
 void HantekDsoControl::enableSamplingUI( bool enabled ) {
     if ( verboseLevel > 3 )
         qDebug() << "   HDC::enableSampling()" << enabled;
+    if ( enabled && !sequenceRunning ) // continue normal sampling, free the segments of the last sequence
+        segmentPool.release();
+    else if ( !enabled && sequenceRunning )
+        stopSequence();
     if ( enabled && controlsettings.trigger.mode == Dso::TriggerMode::SINGLE )
         triggering->resetTriggeredPositionRaw(); // invalidate previous result, wait for new trigger
     else if ( controlsettings.trigger.mode == Dso::TriggerMode::ROLL )
@@ -567,6 +724,13 @@ Dso::ErrorCode HantekDsoControl::getCalibrationFromEEPROM() {
     int errorCode = -1;
     if ( scopeDevice->isRealHW() && specification->hasCalibrationEEPROM )
         errorCode = scopeDevice->controlRead( &controlsettings.cmdGetCalibration );
+    else if ( scopeDevice->isPlayback() ) { // use the calibration and the corrections of the recording scope
+        const RawFileHeader &header = scopeDevice->getPlayer()->getFileHeader();
+        memcpy( controlsettings.cmdGetCalibration.data(), &header.calibration, sizeof( CalibrationValues ) );
+        memcpy( controlsettings.calibrationValues, &header.calibration, sizeof( CalibrationValues ) );
+        correctionFromBytes( header.correction );
+        errorCode = 0;
+    }
     if ( errorCode < 0 ) {
         // invalidate the calibration values.
         memset( controlsettings.calibrationValues, 0xFF, sizeof( CalibrationValues ) );
@@ -726,10 +890,97 @@ static uint8_t offsetToFine( double offset ) {
 }
 
 
-void HantekDsoControl::convertRawDataToSamples() {
-    QReadLocker rawLocker( &raw.lock );
+void HantekDsoControl::correctionToBytes( CalibrationValues &correction ) const {
+    // same encoding as the live calibration: calibration and correction combined, ls and hs get the same offset
+    memset( &correction, 0, sizeof( CalibrationValues ) );
+    const CalibrationValues *calibration = controlsettings.calibrationValues;
+    for ( unsigned gainIndex = 0; gainIndex < HANTEK_GAIN_STEPS; ++gainIndex ) {
+        for ( unsigned channel = 0; channel < HANTEK_CHANNEL_NUMBER; ++channel ) {
+            double offset = offsetCorrection[ gainIndex ][ channel ] +
+                            bytesToOffset( calibration->off.ls.step[ gainIndex ][ channel ],
+                                           calibration->fine.ls.step[ gainIndex ][ channel ] );
+            correction.off.ls.step[ gainIndex ][ channel ] = offsetToRaw( offset );
+            correction.fine.ls.step[ gainIndex ][ channel ] = offsetToFine( offset );
+            offset = offsetCorrection[ gainIndex ][ channel ] + bytesToOffset( calibration->off.hs.step[ gainIndex ][ channel ],
+                                                                                calibration->fine.hs.step[ gainIndex ][ channel ] );
+            correction.off.hs.step[ gainIndex ][ channel ] = offsetToRaw( offset );
+            correction.fine.hs.step[ gainIndex ][ channel ] = offsetToFine( offset );
+            correction.gain.step[ gainIndex ][ channel ] =
+                gainToByte( gainCorrection[ gainIndex ][ channel ] * byteToGain( calibration->gain.step[ gainIndex ][ channel ] ) );
+        }
+    }
+}
+
+
+void HantekDsoControl::correctionFromBytes( const CalibrationValues &correction ) {
+    // invalid bytes (0 or 0xFF, e.g. out of range or an old recording) keep the correction from the ini file
+    const CalibrationValues *calibration = controlsettings.calibrationValues;
+    for ( unsigned gainIndex = 0; gainIndex < HANTEK_GAIN_STEPS; ++gainIndex ) {
+        for ( unsigned channel = 0; channel < HANTEK_CHANNEL_NUMBER; ++channel ) {
+            const uint8_t offsetRaw = correction.off.ls.step[ gainIndex ][ channel ];
+            const uint8_t offsetFine = correction.fine.ls.step[ gainIndex ][ channel ];
+            if ( offsetRaw && offsetRaw != 255 && offsetFine && offsetFine != 255 )
+                offsetCorrection[ gainIndex ][ channel ] =
+                    bytesToOffset( offsetRaw, offsetFine ) - bytesToOffset( calibration->off.ls.step[ gainIndex ][ channel ],
+                                                                            calibration->fine.ls.step[ gainIndex ][ channel ] );
+            const uint8_t gain = correction.gain.step[ gainIndex ][ channel ];
+            if ( gain && gain != 255 )
+                gainCorrection[ gainIndex ][ channel ] =
+                    byteToGain( gain ) / byteToGain( calibration->gain.step[ gainIndex ][ channel ] );
+        }
+    }
+}
+
+
+// Raw blocks are summed in chunks of this size, the workers are used only for blocks of at least this size.
+// 256 KB keep the overhead of the thread handshake below 1% and fit into the L2 cache.
+static const unsigned CONVERSION_CHUNK_BYTES = 256 * 1024;
+
+
+void HantekDsoControl::rawConversion( const Raw &raw, ChannelID channel, double &offset, double &scale, double &offsetCalibration,
+                                      double &gainCalibration ) const {
+    const unsigned gainIndex = raw.gainIndex[ channel ];
+    const double voltageScale = specification->voltageScale[ channel ][ gainIndex ];
+    const double probeAttn = controlsettings.voltage[ channel ].probeAttn;
+    const double sign = controlsettings.voltage[ channel ].inverted ? -1.0 : 1.0;
+    // calibration values from EEPROM[ 8 .. 39 and (if available) 56 .. 87] and the corrections of the live calibration
+    if ( raw.samplerate / raw.oversampling < 30e6 )
+        offsetCalibration = bytesToOffset( controlsettings.calibrationValues->off.ls.step[ gainIndex ][ channel ],
+                                           controlsettings.calibrationValues->fine.ls.step[ gainIndex ][ channel ] );
+    else
+        offsetCalibration = bytesToOffset( controlsettings.calibrationValues->off.hs.step[ gainIndex ][ channel ],
+                                           controlsettings.calibrationValues->fine.hs.step[ gainIndex ][ channel ] );
+    gainCalibration = byteToGain( controlsettings.calibrationValues->gain.step[ gainIndex ][ channel ] );
+    offset = offsetCalibration + offsetCorrection[ gainIndex ][ channel ];
+    scale = sign * gainCorrection[ gainIndex ][ channel ] * gainCalibration * probeAttn / voltageScale;
+}
+
+
+// In NORMAL mode most blocks do not trigger, the check of the raw codes of the trigger channel is much cheaper than
+// the conversion of all channels, the math channel and the trigger search.
+bool HantekDsoControl::rawMayTrigger( const Raw &raw ) const {
+    const ChannelID channel = ChannelID( controlsettings.trigger.source );
+    if ( raw.freeRun || scope->liveCalibrationActive || channel >= raw.channels || !raw.oversampling )
+        return true; // roll mode, live calibration and math channel need the conversion
+    const unsigned rawSampleCount = unsigned( raw.data.size() ) / raw.channels;
+    if ( rawSampleCount / raw.oversampling < SAMPLESIZE ) // free running, no trigger search
+        return true;
+    const unsigned skipSamples = rawSampleCount - netSampleCount( rawSampleCount );
+    double offset;
+    double scale;
+    double offsetCalibration;
+    double gainCalibration;
+    rawConversion( raw, channel, offset, scale, offsetCalibration, gainCalibration );
+    return triggering->mayTrigger( raw.data.data() + skipSamples * raw.channels, raw.channels, rawSampleCount - skipSamples,
+                                   offset, scale );
+}
+
+
+void HantekDsoControl::convertRawDataToSamples( const Raw &raw ) {
+    // free run: the settings come with the block, the samples are filled step by step into the roll buffer
+    const std::vector< unsigned char > &rawData = raw.freeRun ? rollRaw.data : raw.data;
     activeChannels = raw.channels;
-    const unsigned rawSampleCount = unsigned( raw.data.size() ) / activeChannels;
+    const unsigned rawSampleCount = unsigned( rawData.size() ) / activeChannels;
     if ( !rawSampleCount )
         return;
     const unsigned rawOversampling = raw.oversampling;
@@ -740,78 +991,114 @@ void HantekDsoControl::convertRawDataToSamples() {
     if ( verboseLevel > 4 )
         qDebug() << "    HDC::convertRawDataToSamples()" << raw.tag;
     QWriteLocker resultLocker( &result.lock );
+    triggering->reclaimTriggeredData( result ); // do not overwrite the saved triggered trace
     result.freeRunning = freeRunning;
     result.tag = raw.tag;
+    result.timeStart = raw.timeStart;
+    result.timeEnd = raw.timeEnd;
     result.samplerate = raw.samplerate / raw.oversampling;
     // Prepare result buffers
     result.data.resize( specification->channels + 1 ); // CH0, CH1, MATH
-    for ( ChannelID channelCounter = 0; channelCounter <= specification->channels; ++channelCounter )
+    result.statistics.resize( specification->channels + 1 );
+    for ( ChannelID channelCounter = 0; channelCounter <= specification->channels; ++channelCounter ) {
         result.data[ channelCounter ].clear();
+        result.statistics[ channelCounter ].clear();
+    }
+
+    // Deinterleave the raw data and sum the oversampled values of all channels in one (vectorized) pass
+    const unsigned groupBytes = rawOversampling * activeChannels;
+    const unsigned rawBytes = rawSampleCount * activeChannels;
+    uint32_t *sums[ HANTEK_CHANNEL_NUMBER ] = { nullptr };
+    RawKernel::ChannelStatistics statistics[ HANTEK_CHANNEL_NUMBER ];
+    bool clipped[ HANTEK_CHANNEL_NUMBER ] = { false };
+    uint64_t clipCount[ HANTEK_CHANNEL_NUMBER ] = { 0 };
+    for ( ChannelID channel = 0; channel < activeChannels; ++channel ) {
+        rawSums[ channel ].resize( resultSamples );
+        sums[ channel ] = rawSums[ channel ].data();
+    }
+    if ( raw.freeRun && freeRunning && !scope->liveCalibrationActive ) { // roll mode, process only the new raw samples
+        sumRollGroups( raw.tag, rawData, rawOversampling, resultSamples, clipped, clipCount );
+    } else {
+        // split the raw data into chunks of complete groups that are summed independently (in parallel if big)
+        struct SumChunk {
+            unsigned rawBufPos;
+            unsigned index;
+            unsigned groups;
+            RawKernel::ChannelStatistics statistics[ HANTEK_CHANNEL_NUMBER ];
+        };
+        std::vector< SumChunk > chunks;
+        const unsigned chunkGroups = qMax( 1u, CONVERSION_CHUNK_BYTES / groupBytes );
+        unsigned rawBufPos = 0;
+        if ( raw.freeRun && rollRaw.rollMode ) // show the "new" samples on the right screen side
+            rawBufPos = rollRaw.received;      // start with remaining "old" samples in buffer
+        rawBufPos += skipSamples * activeChannels; // skip first unstable samples
+        for ( unsigned index = 0; index < resultSamples; ) {
+            if ( rawBufPos + groupBytes > rawBytes )
+                rawBufPos = 0; // (roll mode) show "new" samples after the "old" samples
+            const unsigned groups = qMin( qMin( resultSamples - index, ( rawBytes - rawBufPos ) / groupBytes ), chunkGroups );
+            if ( !groups )
+                break;
+            chunks.push_back( SumChunk{ rawBufPos, index, groups, {} } );
+            rawBufPos += groups * groupBytes;
+            index += groups;
+        }
+        workerPool.run( unsigned( chunks.size() ), [ & ]( unsigned chunkIndex ) {
+            SumChunk &chunk = chunks[ chunkIndex ];
+            uint32_t *chunkSums[ HANTEK_CHANNEL_NUMBER ] = { nullptr };
+            for ( ChannelID channel = 0; channel < activeChannels; ++channel )
+                chunkSums[ channel ] = sums[ channel ] + chunk.index;
+            RawKernel::sumGroups( rawData.data() + chunk.rawBufPos, activeChannels, rawOversampling, chunk.groups, chunkSums,
+                                  chunk.statistics );
+        } );
+        for ( const SumChunk &chunk : chunks ) {
+            for ( ChannelID channel = 0; channel < activeChannels; ++channel ) {
+                const RawKernel::ChannelStatistics &chunkStatistics = chunk.statistics[ channel ];
+                statistics[ channel ].min = qMin( statistics[ channel ].min, chunkStatistics.min );
+                statistics[ channel ].max = qMax( statistics[ channel ].max, chunkStatistics.max );
+                statistics[ channel ].sum += chunkStatistics.sum;
+                statistics[ channel ].clipped += chunkStatistics.clipped;
+            }
+        }
+        for ( ChannelID channel = 0; channel < activeChannels; ++channel ) { // min or max -> clipped
+            clipped[ channel ] = statistics[ channel ].min == 0x00 || statistics[ channel ].max == 0xFF;
+            clipCount[ channel ] = statistics[ channel ].clipped;
+        }
+    }
 
     // Convert channel data
     // Channels are using their separate buffers
     for ( ChannelID channel = 0; channel < activeChannels; ++channel ) {
         const unsigned gainIndex = raw.gainIndex[ channel ];
-        const double voltageScale = specification->voltageScale[ channel ][ gainIndex ];
-        const double probeAttn = controlsettings.voltage[ channel ].probeAttn;
-        const double sign = controlsettings.voltage[ channel ].inverted ? -1.0 : 1.0;
-
-        // shift + individual offset for each channel and gain
-        // get offset value from eeprom[ 8 .. 39 and (if available) 56 .. 87]
-        uint8_t offsetRaw;
-        uint8_t offsetFine;
-        if ( result.samplerate < 30e6 ) {
-            offsetRaw = controlsettings.calibrationValues->off.ls.step[ gainIndex ][ channel ];
-            offsetFine = controlsettings.calibrationValues->fine.ls.step[ gainIndex ][ channel ];
-        } else {
-            offsetRaw = controlsettings.calibrationValues->off.hs.step[ gainIndex ][ channel ];
-            offsetFine = controlsettings.calibrationValues->fine.hs.step[ gainIndex ][ channel ];
-        }
-        // calibration values from EEPROM
-        channelOffset[ channel ] = offsetRaw;
-        double offsetCalibration = bytesToOffset( offsetRaw, offsetFine );
-        double gainCalibration = byteToGain( controlsettings.calibrationValues->gain.step[ gainIndex ][ channel ] );
         // Convert data from the oscilloscope and write it into the channel sample buffer
-        unsigned rawBufPos = 0;
-        if ( raw.freeRun && raw.rollMode ) // show the "new" samples on the right screen side
-            rawBufPos = raw.received;      // start with remaining "old" samples in buffer
         result.data[ channel ].resize( resultSamples );
-        rawBufPos += skipSamples * activeChannels; // skip first unstable samples
-        result.clipped &= ~( 0x01 << channel );    // clear clipping flag
+        result.clipped &= ~( 0x01 << channel ); // clear clipping flag
 
         double gainCorr = gainCorrection[ gainIndex ][ channel ];
-        double offsetCorr = offsetCorrection[ gainIndex ][ channel ];
-        double liveOffset = 0.0;
-
-        int minValue = 0xFF;
-        int maxValue = 0x00;
 
-        for ( unsigned index = 0; index < resultSamples;
-              ++index, rawBufPos += activeChannels * rawOversampling ) { // advance either by one or two blocks
-            if ( rawBufPos + rawOversampling * activeChannels > rawSampleCount * activeChannels )
-                rawBufPos = 0; // (roll mode) show "new" samples after the "old" samples
-            double sample = 0.0;
-            for ( unsigned iii = 0; iii < rawOversampling * activeChannels; iii += activeChannels ) {
-                int rawSample = raw.data[ rawBufPos + channel + iii ]; // CH1/CH2/CH1/CH2 ...
-                if ( rawSample == 0x00 || rawSample == 0xFF )          // min or max -> clipped
-                    result.clipped |= 0x01 << channel;
-                if ( rawSample > maxValue )
-                    maxValue = rawSample;
-                if ( rawSample < minValue )
-                    minValue = rawSample;
-                sample += double( rawSample ) - offsetCalibration;
-            }
-            sample /= rawOversampling;
-            if ( scope->liveCalibrationActive ) {
-                liveOffset += sample;
-            }
-            // qDebug() << channel << offsetCorrection[ gainIndex ][ channel ];
-            sample -= offsetCorr;
-            sample *= gainCorr;
-
-            result.data[ channel ][ index ] = sign * sample / voltageScale * gainCalibration * probeAttn;
+        // the 8 bit ADC code is converted with a table lookup, all calibration and scaling factors are
+        // combined into one linear function, the table is built only if gain, calibration, probe or inversion change
+        ConversionTable &table = conversionTable[ channel ];
+        double tableOffset;
+        double tableScale;
+        double offsetCalibration;
+        double gainCalibration;
+        rawConversion( raw, channel, tableOffset, tableScale, offsetCalibration, gainCalibration );
+        channelOffset[ channel ] = uint8_t( qBound( 0.0, round( offsetCalibration ), 255.0 ) ); // the ADC code of 0 V
+        tableScale /= rawOversampling;
+        if ( tableOffset != table.offset || tableScale != table.scale ) {
+            for ( unsigned rawValue = 0; rawValue < 256; ++rawValue )
+                table.value[ rawValue ] = ( rawValue - tableOffset ) * tableScale;
+            table.offset = tableOffset;
+            table.scale = tableScale;
         }
-        liveOffset /= resultSamples;
+        result.statistics[ channel ].clipped = clipCount[ channel ];
+        const uint8_t minValue = statistics[ channel ].min;
+        const uint8_t maxValue = statistics[ channel ].max;
+        if ( resultSamples && clipped[ channel ] )
+            result.clipped |= 0x01 << channel;
+        // average of the offset calibrated samples
+        const unsigned rawCount = resultSamples * rawOversampling;
+        double liveOffset = rawCount ? double( statistics[ channel ].sum ) / rawCount - offsetCalibration : 0.0;
 
         if ( scope->liveCalibrationActive ) {
             if ( maxValue - minValue > 10 || liveOffset > 20 ) { // big jitter/noise, offset too big
@@ -833,9 +1120,102 @@ void HantekDsoControl::convertRawDataToSamples() {
             }
         }
     }
+
+    // Apply the conversion tables, the channels are independent and big blocks are converted in parallel
+    auto convertChannel = [ & ]( unsigned channel ) {
+        const ConversionTable &table = conversionTable[ channel ];
+        const uint32_t *rawSum = rawSums[ channel ].data();
+        Sample *samples = result.data[ channel ].data();
+        const double *lookup = table.value;
+        const double sumOffset = table.offset * rawOversampling;
+        const double tableScale = table.scale;
+        // convert block by block, the statistics of each block are taken while it is still in the L1 cache
+        SampleStatistics &sampleStatistics = result.statistics[ channel ];
+        for ( unsigned first = 0; first < resultSamples; first += SampleStatistics::BLOCK_SIZE ) {
+            const unsigned last = qMin( first + SampleStatistics::BLOCK_SIZE, resultSamples );
+            if ( rawOversampling == 1 ) { // the sums are the raw values
+                for ( unsigned index = first; index < last; ++index )
+                    samples[ index ] = Sample( lookup[ rawSum[ index ] ] );
+            } else { // the table function applied to the sum, the table scale includes 1/rawOversampling
+                for ( unsigned index = first; index < last; ++index )
+                    samples[ index ] = Sample( ( rawSum[ index ] - sumOffset ) * tableScale );
+            }
+            sampleStatistics.addBlock( samples + first, last - first );
+        }
+    };
+    if ( rawBytes >= CONVERSION_CHUNK_BYTES ) // worth to start the workers
+        workerPool.run( activeChannels, convertChannel );
+    else
+        for ( ChannelID channel = 0; channel < activeChannels; ++channel )
+            convertChannel( channel );
 } // convertRawDataToSamples()
 
 
+// Roll mode: the CapturingThread writes the raw samples continuously into the circular buffer rollRaw.data.
+// Only the groups of raw values that were completed since the last call are summed into the circular buffer
+// rollSums, the sums of the complete buffer are then copied into rawSums, oldest group first.
+// The buffer is summed completely after a change of the layout or if a complete lap was missed.
+void HantekDsoControl::sumRollGroups( unsigned tag, const std::vector< unsigned char > &rawData, unsigned oversampling,
+                                      unsigned resultSamples, bool clipped[], uint64_t clipCount[] ) {
+    const unsigned channels = activeChannels;
+    const unsigned groupBytes = oversampling * channels;
+    const unsigned groups = unsigned( rawData.size() ) / groupBytes;
+    const unsigned written = qMin( rollRaw.received, unsigned( rawData.size() ) ) / groupBytes; // complete groups of this lap
+    if ( !groups )
+        return;
+
+    uint32_t *sums[ HANTEK_CHANNEL_NUMBER ] = { nullptr };
+    // sum the groups [first, last) into rollSums, remember the position of clipped values
+    auto sumRange = [ & ]( unsigned first, unsigned last ) {
+        if ( first >= last )
+            return;
+        RawKernel::ChannelStatistics statistics[ HANTEK_CHANNEL_NUMBER ];
+        for ( ChannelID channel = 0; channel < channels; ++channel )
+            sums[ channel ] = rollSums[ channel ].data() + first;
+        RawKernel::sumGroups( rawData.data() + size_t( first ) * groupBytes, channels, oversampling, last - first, sums,
+                              statistics );
+        rollGroupCount += last - first;
+        for ( ChannelID channel = 0; channel < channels; ++channel ) {
+            if ( statistics[ channel ].min == 0x00 || statistics[ channel ].max == 0xFF )
+                rollClipped[ channel ] = rollGroupCount;
+            clipCount[ channel ] += statistics[ channel ].clipped;
+        }
+    };
+
+    if ( groups != rollGroups || channels != rollChannels || oversampling != rollOversampling || tag - rollTag > 1 ) {
+        for ( ChannelID channel = 0; channel < channels; ++channel ) {
+            rollSums[ channel ].resize( groups );
+            rollClipped[ channel ] = 0;
+        }
+        rollGroups = groups;
+        rollChannels = channels;
+        rollOversampling = oversampling;
+        sumRange( 0, groups );
+    } else if ( tag != rollTag ) { // next lap, finish the previous lap and start from the beginning
+        sumRange( rollConverted, groups );
+        sumRange( 0, written );
+    } else if ( written >= rollConverted ) { // same lap
+        sumRange( rollConverted, written );
+    } else { // the start of the lap was seen after the tag change
+        sumRange( 0, written );
+    }
+    rollConverted = written;
+    rollTag = tag;
+
+    // copy the sums rotated, the oldest complete group first, the group that is written just now is skipped
+    const unsigned start = rollRaw.rollMode ? ( written + 1 ) % groups : 0;
+    const unsigned count = qMin( resultSamples, groups );
+    for ( ChannelID channel = 0; channel < channels; ++channel ) {
+        const uint32_t *source = rollSums[ channel ].data();
+        uint32_t *target = rawSums[ channel ].data();
+        const unsigned firstPart = qMin( count, groups - start );
+        std::copy( source + start, source + start + firstPart, target );
+        std::copy( source, source + count - firstPart, target + firstPart );
+        clipped[ channel ] = rollClipped[ channel ] && rollGroupCount - rollClipped[ channel ] < groups;
+    }
+}
+
+
 /// \brief Updates the interval of the periodic thread timer.
 void HantekDsoControl::updateInterval() {
     // Check the current oscilloscope state every time 25% of the time
@@ -861,44 +1241,78 @@ void HantekDsoControl::updateInterval() {
 void HantekDsoControl::stateMachine() {
 
     bool triggered = false;
+    const Raw *raw = nullptr;
+    if ( sequenceRunning && !segmentPool.isActive() ) { // sequence complete (or cancelled)
+        sequenceRunning = false;
+        enableSamplingUI( false );
+        if ( segmentPool.isComplete() && segmentPool.getCount() ) {
+            emit statusMessage( tr( "Sequence of %1 blocks captured" ).arg( segmentPool.getCount() ), 3000 );
+            showSegment( 0 );
+        } else {
+            segmentPool.release();
+        }
+    }
+    if ( sequenceRunning ) { // no processing until the sequence is complete
+        raw = nullptr;
+    } else if ( segmentPool.isComplete() ) { // browse the segments of the last sequence
+        raw = &segmentPool.segment( segmentIndex );
+    } else { // get the newest (or the next) captured block, the last one is kept if nothing new is available
+        raw = rawQueue.readBlock();
+    }
+    const unsigned rawTag = raw ? raw->tag : 0;
     if ( verboseLevel > 4 )
-        qDebug() << "    HDC::stateMachine()" << raw.tag;
+        qDebug() << "    HDC::stateMachine()" << rawTag;
+
+    delayDisplay += qMax( acquireInterval, 1 ); // count up with every state machine loop
+    // always run the display (slowly at t=displayInterval) to allow user interaction
+    // skip an even number of frames when slope == Dso::Slope::Both
+    const bool displayDue = ( delayDisplay >= displayInterval )                        // wait some time ...
+                            && ( ( controlsettings.trigger.slope != Dso::Slope::Both ) // ... for ↗ or ↘ slope
+                                 || skipEven );                                        // and drop even no. of frames
 
     // we have a sample available ...
     // ... that is either a new sample or we are in free run mode or a new trigger search is needed
-    static unsigned lastTag = UINT32_MAX; // detect new raw data
-    if ( samplingStarted && raw.valid && ( raw.tag != lastTag || raw.freeRun || refreshNeeded() ) ) {
-        lastTag = raw.tag;
-        convertRawDataToSamples(); // process samples, apply gain settings etc.
-        mathChannel->calculate( result );
-        QWriteLocker resultLocker( &result.lock );
-        if ( !result.freeRunning ) { // trigger mode != NONE
-            // trigger functions below are in separate file "triggering.cpp"
-            triggering->searchTriggeredPosition( result );          // detect trigger point
-            triggered = triggering->provideTriggeredData( result ); // present either free running or last triggered trace
-        } else {                                                    // free running display
-            triggered = false;
-            result.triggeredPosition = 0;
+    if ( samplingStarted && raw && raw->valid &&
+         ( rawTag != lastTag || ( raw->freeRun && triggerModeNONE() ) || refreshNeeded() ) ) {
+        lastTag = rawTag;
+        // a block that cannot trigger is not converted if the untriggered trace is not shown,
+        // NORMAL mode shows the last triggered trace, the other modes show it only when the display is due
+        if ( !triggerModeNONE() && ( controlsettings.trigger.mode == Dso::TriggerMode::NORMAL || !displayDue ) &&
+             !rawMayTrigger( *raw ) ) {
+            triggering->resetTriggeredPositionRaw();
+            if ( displayDue ) { // NORMAL mode: provide the saved triggered trace
+                QWriteLocker resultLocker( &result.lock );
+                result.tag = raw->tag;
+                result.timeStart = raw->timeStart;
+                result.timeEnd = raw->timeEnd;
+                result.triggeredPosition = 0;
+                result.triggerOffset = 0.0;
+                triggered = triggering->provideTriggeredData( result );
+            }
+        } else {
+            convertRawDataToSamples( *raw ); // process samples, apply gain settings etc.
+            mathChannel->calculate( result );
+            QWriteLocker resultLocker( &result.lock );
+            if ( !result.freeRunning ) { // trigger mode != NONE
+                // trigger functions below are in separate file "triggering.cpp"
+                triggering->searchTriggeredPosition( result );          // detect trigger point
+                triggered = triggering->provideTriggeredData( result ); // present either free running or last triggered trace
+            } else {                                                    // free running display
+                triggered = false;
+                result.triggeredPosition = 0;
+                result.triggerOffset = 0.0;
+                result.triggerEvents.clear();
+            }
         }
     } else { // TODO: check if this is needed anymore: start with correct calibration frequency
-        static bool firstFreq = true;
         if ( firstFreq && scope ) {
             setCalFreq( scope->horizontal.calfreq );
             firstFreq = false;
         }
     }
-    static int delayDisplay = 0;                // timer for display
-    static bool lastTriggered = false;          // state of last frame
-    static bool skipEven = true;                // even or odd frames were skipped
-    delayDisplay += qMax( acquireInterval, 1 ); // count up with every state machine loop
-    // always run the display (slowly at t=displayInterval) to allow user interaction
     // ... but update immediately if new triggered data is available after untriggered
-    // skip an even number of frames when slope == Dso::Slope::Both
-    if ( ( triggered && !lastTriggered )                                 // show new data immediately
-         || ( ( delayDisplay >= displayInterval )                        // or wait some time ...
-              && ( ( controlsettings.trigger.slope != Dso::Slope::Both ) // ... for ↗ or ↘ slope
-                   || skipEven ) ) ) {                                   // and drop even no. of frames
-        skipEven = true;                                                 // zero frames -> even
+    if ( ( triggered && !lastTriggered ) || displayDue ) {
+        skipEven = true; // zero frames -> even
         delayDisplay = 0;
         timestampDebug( QString( "samplesAvailable %1" ).arg( result.tag ) );
         emit samplesAvailable( &result ); // via signal/slot -> PostProcessing::input()
@@ -907,11 +1321,10 @@ void HantekDsoControl::stateMachine() {
     }
     lastTriggered = triggered; // save state
 
-    static bool skipFirstSingle = true; // skip 1st triggered single trace to avoid old data
     // Stop sampling if we're in single trigger mode and have a triggered trace (txh No13)
     if ( isSamplingUI() && controlsettings.trigger.mode == Dso::TriggerMode::SINGLE && triggering->getTriggeredPositionRaw() ) {
         if ( verboseLevel > 5 )
-            qDebug() << "     HDC::stateMachine() stop sampling" << raw.tag;
+            qDebug() << "     HDC::stateMachine() stop sampling" << rawTag;
         if ( skipFirstSingle ) { // skip the 1st measurement in single mode
             skipFirstSingle = false;
         } else {
@@ -921,7 +1334,7 @@ void HantekDsoControl::stateMachine() {
     }
 
     if ( isSamplingUI() ) { // triggered by action "start sampling" and call to enableSampling()
-        lastTag = raw.tag;
+        lastTag = rawTag;
         // Sampling hasn't started, update the expected sample count
         expectedSampleCount = getSampleCount();
         timestampDebug( "Starting to capture" );
@@ -979,6 +1392,7 @@ Dso::ErrorCode HantekDsoControl::stringCommand( const QString &commandString ) {
             name = controlNames[ codeIndex - 0xe0 ];
 
         ControlCommand *c = modifyCommand< ControlCommand >( ControlCode( codeIndex ) );
+        c->invalidateSent(); // manual commands are sent always
         hexParse( data, c->data(), unsigned( c->size() ) );
         if ( verboseLevel > 2 )
             qDebug().noquote() << "  " + commandParts[ 0 ]
@@ -987,6 +1401,12 @@ Dso::ErrorCode HantekDsoControl::stringCommand( const QString &commandString ) {
         if ( int( c->size() ) != commandParts.count() - 2 )
             return Dso::ErrorCode::PARAMETER;
         return Dso::ErrorCode::NONE;
+    } else if ( commandParts[ 0 ] == "demo" ) { // configure the demo signals, e.g. "demo 1 sine 1000 2"
+        if ( scopeDevice->isRealHW() || scopeDevice->isPlayback() )
+            return Dso::ErrorCode::UNSUPPORTED;
+        if ( !demoGenerator.configure( commandString.section( ' ', 1, -1, QString::SectionSkipEmpty ) ) )
+            return Dso::ErrorCode::PARAMETER;
+        return Dso::ErrorCode::NONE;
     } else if ( commandParts[ 0 ] == "freq" ) {     // simple example for manual frequency command "freq nn"
         if ( commandParts.count() < 2 )             // command and one parameter needed
             return Dso::ErrorCode::PARAMETER;       // .. otherwise -> error
@@ -12,19 +12,25 @@
 
 #include "controlsettings.h"
 #include "controlspecification.h"
+#include "demogenerator.h"
 #include "dsosamples.h"
 #include "errorcodes.h"
 #include "mathchannel.h"
+#include "rawqueue.h"
+#include "rawrecorder.h"
 #include "scopesettings.h"
+#include "segmentpool.h"
 #include "triggering.h"
 #include "utils/printutils.h"
 #include "viewconstants.h"
+#include "workerpool.h"
 
 #include "hantekprotocol/controlStructs.h"
 #include "hantekprotocol/definitions.h"
 
 #include "dsomodel.h"
 
+#include <atomic>
 #include <vector>
 
 #include <QSettings>
@@ -33,23 +39,6 @@
 class CapturingThread;
 class ScopeDevice;
 
-struct Raw {
-    unsigned channels = 0;
-    double samplerate = 0;
-    unsigned oversampling = 0;
-    unsigned gainValue[ 2 ] = { 1, 1 }; // 1,2,5,10,..
-    unsigned gainIndex[ 2 ] = { 7, 7 }; // index 0..7
-    unsigned tag = 0;
-    bool freeRun = false;  // small buffer, no trigger
-    bool valid = false;    // samples can be processed
-    bool rollMode = false; // one complete buffer received, start to roll
-    unsigned size = 0;
-    unsigned received = 0;
-    std::vector< unsigned char > data;
-    mutable QReadWriteLock lock;
-};
-
-
 /// \brief The DsoControl abstraction layer for %Hantek USB DSOs.
 /// TODO Please anyone, refactor this class into smaller pieces (Separation of Concerns!).
 class HantekDsoControl : public QObject {
@@ -88,6 +77,11 @@ class HantekDsoControl : public QObject {
 
     bool isSamplingUI() const { return samplingUI; }
 
+    /// \brief Process every captured block (e.g. for recording) or only the newest one (default, lowest latency).
+    void setProcessEveryBlock( bool every ) { rawQueue.setEveryBlock( every ); }
+    bool isProcessEveryBlock() const { return rawQueue.isEveryBlock(); }
+    unsigned getDroppedBlocks() const { return rawQueue.getDropped(); }
+
     /// Return the associated usb device.
     const ScopeDevice *getDevice() const { return scopeDevice; }
 
@@ -108,6 +102,12 @@ class HantekDsoControl : public QObject {
 
     void addCommand( ControlCommand *newCommand, bool pending = true );
 
+    /// \brief Collect the following setting changes and send them together with the next block.
+    /// Without a batch CapturingThread may send the 1st changes, capture one block with the mixed settings and
+    /// send the rest with the next block. Batches can be nested, the commands are released by the last endCommandBatch().
+    void beginCommandBatch() { ++commandBatch; }
+    void endCommandBatch() { --commandBatch; }
+
     template < class T > T *modifyCommand( Hantek::ControlCode code ) {
         control[ uint8_t( code ) ]->pending = true;
         return static_cast< T * >( control[ uint8_t( code ) ] );
@@ -123,6 +123,18 @@ class HantekDsoControl : public QObject {
     /// \brief Saves calibration settings e.g. to the scope's EEPROM
     void prepareForShutdown();
 
+    /// \brief Record the raw ADC samples of every captured block into (memory mapped) file(s).
+    /// \param fileName Name of the recording, further segments are numbered (see RawRecorder).
+    /// \param maxSegments Keep only the last maxSegments files, 0 = keep all.
+    /// \return true if the recording was started.
+    bool startRecording( const QString &fileName, unsigned maxSegments = 0 );
+    void stopRecording();
+    bool isRecording() const { return rawRecorder.isRecording(); }
+
+    /// \brief Sequence mode: the number of captured segments and the segment that is shown.
+    unsigned getSegmentCount() const { return segmentPool.isComplete() ? segmentPool.getCount() : 0; }
+    unsigned getSegmentIndex() const { return segmentIndex; }
+
   private:
     std::unique_ptr< MathChannel > mathChannel;
     std::unique_ptr< Triggering > triggering;
@@ -153,7 +165,25 @@ class HantekDsoControl : public QObject {
     void updateInterval();
 
     /// \brief Converts raw oscilloscope data to sample data
-    void convertRawDataToSamples();
+    void convertRawDataToSamples( const Raw &raw );
+
+    /// \brief The calibrated conversion of one raw ADC code of a channel: voltage = ( code - offset ) * scale
+    /// \param offsetCalibration, gainCalibration The EEPROM calibration values used, without the live corrections.
+    void rawConversion( const Raw &raw, ChannelID channel, double &offset, double &scale, double &offsetCalibration,
+                        double &gainCalibration ) const;
+
+    /// \brief Encode the offset and gain corrections in the byte format of the EEPROM calibration (for a raw recording)
+    void correctionToBytes( Hantek::CalibrationValues &correction ) const;
+    /// \brief Restore the offset and gain corrections from the bytes stored with a raw recording
+    void correctionFromBytes( const Hantek::CalibrationValues &correction );
+
+    /// \brief Quick check on the raw codes of the trigger channel, false: the block cannot trigger
+    bool rawMayTrigger( const Raw &raw ) const;
+
+    /// \brief Roll mode: sum only the newly received raw values, provide the sums of the whole buffer in rawSums
+    /// and the number of clipped values of the newly received raw values in clipCount
+    void sumRollGroups( unsigned tag, const std::vector< unsigned char > &rawData, unsigned oversampling, unsigned resultSamples,
+                        bool clipped[], uint64_t clipCount[] );
 
     /// \brief Restore the samplerate/timebase targets after divider updates.
     void restoreTargets();
@@ -161,11 +191,15 @@ class HantekDsoControl : public QObject {
     /// \brief Update the minimum and maximum supported samplerate.
     void updateSamplerateLimits();
 
+    /// \brief The maximum samplerate for the actual channel and USB transfer mode.
+    double getSamplerateLimit() const;
+
     void controlSetSamplerate( uint8_t sampleIndex );
 
     /// Pointers to control commands
     ControlCommand *control[ 255 ] = { nullptr };
     ControlCommand *firstControlCommand = nullptr;
+    std::atomic< int > commandBatch{ 0 }; ///< > 0: setting changes are collected, CapturingThread does not send them
 
     // Communication with device
     ScopeDevice *scopeDevice;  ///< The USB device for the oscilloscope
@@ -187,9 +221,37 @@ class HantekDsoControl : public QObject {
     std::unique_ptr< QSettings > calibrationSettings;
     double offsetCorrection[ HANTEK_GAIN_STEPS ][ HANTEK_CHANNEL_NUMBER ];
     double gainCorrection[ HANTEK_GAIN_STEPS ][ HANTEK_CHANNEL_NUMBER ];
+    /// Raw ADC code -> voltage per channel, valid for the combined linear function (code - offset) * scale
+    struct ConversionTable {
+        double value[ 256 ] = { 0.0 };
+        double offset = 0.0;
+        double scale = 0.0;
+    } conversionTable[ HANTEK_CHANNEL_NUMBER ];
+    std::vector< uint32_t > rawSums[ HANTEK_CHANNEL_NUMBER ]; ///< Sum of the oversampled raw values per result sample
+    WorkerPool workerPool;                                    ///< Shares the conversion of big raw blocks
+    // roll mode: group sums of the circular buffer rollRaw.data, updated incrementally by sumRollGroups()
+    std::vector< uint32_t > rollSums[ HANTEK_CHANNEL_NUMBER ];
+    unsigned rollGroups = 0;                              ///< number of groups in the circular buffer
+    unsigned rollChannels = 0;                            ///< layout of the summed groups
+    unsigned rollOversampling = 0;                        ///< layout of the summed groups
+    unsigned rollConverted = 0;                           ///< groups [0, rollConverted) of the actual lap are summed
+    unsigned rollTag = 0;                                 ///< tag of the actual lap
+    uint64_t rollGroupCount = 0;                          ///< total number of summed groups
+    uint64_t rollClipped[ HANTEK_CHANNEL_NUMBER ] = { 0 }; ///< rollGroupCount after the last clipped value, 0: none
     bool capturing = false;
     bool samplingStarted = false;
     bool stateMachineRunning = false;
+    // state machine, members instead of function statics, i.e. each instance keeps its own state
+    unsigned lastTag = UINT32_MAX;                             ///< detect new raw data
+    bool firstFreq = true;                                     ///< set the calibration frequency once
+    int delayDisplay = 0;                                      ///< timer for display
+    bool lastTriggered = false;                                ///< state of last frame
+    bool skipEven = true;                                      ///< even or odd frames were skipped
+    bool skipFirstSingle = true;                               ///< skip 1st triggered single trace to avoid old data
+    Dso::TriggerMode lastTriggerMode = Dso::TriggerMode::AUTO; ///< detect trigger mode changes ROLL <-> !ROLL
+    uint8_t lastSampleIndex = 0xFF;                            ///< detect samplerate changes
+    uint8_t lastGain[ 2 ] = { 0xFF, 0xFF };                    ///< detect HW gain changes
+    int lastCoupling[ 2 ] = { -1, -1 };                        ///< detect HW coupling changes
     int acquireInterval = 0;
     int displayInterval = 0;
     unsigned activeChannels = 2;
@@ -200,7 +262,13 @@ class HantekDsoControl : public QObject {
         refresh = false;
         return changed;
     }
-    Raw raw;
+    RawQueue rawQueue;            // captured blocks, CapturingThread -> HantekDsoControl
+    Raw rollRaw;                  // roll mode: samples are written step by step by CapturingThread and displayed immediately
+    RawRecorder rawRecorder;      // raw sample recording, written by CapturingThread
+    DemoGenerator demoGenerator;  // demo device: signal synthesizer, used by CapturingThread
+    SegmentPool segmentPool;      // sequence mode: N blocks captured back-to-back, processed after the sequence
+    unsigned segmentIndex = 0;    // sequence mode: the segment that is shown
+    bool sequenceRunning = false; // sequence mode: waiting for the end of the sequence
     unsigned debugLevel = 0;
     uint8_t channelOffset[ 2 ] = { 0x80, 0x80 };
 
@@ -273,6 +341,41 @@ class HantekDsoControl : public QObject {
     /// \return See ::Dso::ErrorCode.
     Dso::ErrorCode setTriggerSmooth( int smooth );
 
+    /// \brief Set the trigger type.
+    /// \param type The event that causes a trigger.
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setTriggerType( Dso::TriggerType type );
+
+    /// \brief Set the time condition of the pulse width and slew rate trigger.
+    /// \param condition Less, greater or within the time limits.
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setTriggerCondition( Dso::TriggerCondition condition );
+
+    /// \brief Set the pulse width, slew rate or timeout time.
+    /// \param time The time (s).
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setTriggerTime1( double time );
+
+    /// \brief Set the upper time limit of the condition "within".
+    /// \param time The time (s).
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setTriggerTime2( double time );
+
+    /// \brief Set the distance of the 2nd level for runt, window and slew rate trigger.
+    /// \param height The 2nd level is trigger level + height (V).
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setTriggerHeight( double height );
+
+    /// \brief Set the hysteresis of the trigger level.
+    /// \param hysteresis The signal must pass level -/+ hysteresis before the edge counts (V).
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setTriggerHysteresis( double hysteresis );
+
+    /// \brief Enable the search for all trigger events of a block.
+    /// \param multi true: provide the positions of all events, false: only the triggered position.
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setTriggerMulti( bool multi );
+
     /// \brief Set the trigger level.
     /// \param channel The channel that should be set.
     /// \param level The new trigger level (V).
@@ -304,6 +407,18 @@ class HantekDsoControl : public QObject {
     /// \brief enable/disable offset calibration
     void calibrateOffset( bool enable );
 
+    /// \brief Capture a sequence of blocks back-to-back into preallocated segments without processing them.
+    /// After the sequence the sampling stops and the segments can be browsed with showSegment().
+    /// \param count The number of blocks (segments).
+    void startSequence( unsigned count );
+
+    /// \brief Stop a running sequence, the already captured segments are kept.
+    void stopSequence();
+
+    /// \brief Convert and show one segment of the last sequence.
+    /// \param index The segment number, limited to the available segments.
+    void showSegment( int index );
+
   signals:
     void showSamplingStatus( bool enabled );                   ///< The oscilloscope started/stopped sampling/waiting for trigger
     void statusMessage( const QString &message, int timeout ); ///< Status message about the oscilloscope
@@ -319,6 +434,8 @@ class HantekDsoControl : public QObject {
     void communicationError() const;
 
     void liveCalibrationError() const; // live calibration stopped due to noise or big offset
+
+    void recordingStopped(); ///< The raw sample recording stopped itself, e.g. due to a write error
 };
 
 Q_DECLARE_METATYPE( DSOsamples * )
@@ -19,9 +19,9 @@ void MathChannel::calculate( DSOsamples &result ) {
     const size_t CH1 = 0;
     const size_t CH2 = 1;
     const size_t MATH = 2;
-    const double sign = scope->voltage[ MATH ].inverted ? -1.0 : 1.0;
+    const Sample sign = scope->voltage[ MATH ].inverted ? -1 : 1; // same type as the samples, no double arithmetic
     QWriteLocker resultLocker( &result.lock );
-    std::vector< double > &mathChannel = result.data[ MATH ];
+    std::vector< Sample > &mathChannel = result.data[ MATH ];
     const size_t resultSamples = result.data[ CH1 ].size();
     const Dso::MathMode mathMode = Dso::getMathMode( scope->voltage[ MATH ] );
     mathChannel.resize( resultSamples );
@@ -30,8 +30,8 @@ void MathChannel::calculate( DSOsamples &result ) {
             return;
 
         // Calculate values and write them into the sample buffer
-        std::vector< double >::const_iterator ch1Iterator = result.data[ CH1 ].begin();
-        std::vector< double >::const_iterator ch2Iterator = result.data[ CH2 ].begin();
+        std::vector< Sample >::const_iterator ch1Iterator = result.data[ CH1 ].begin();
+        std::vector< Sample >::const_iterator ch2Iterator = result.data[ CH2 ].begin();
 
         if ( result.clipped & 0x03 ) // at least one channel has clipped
             result.clipped |= 0x04;  // .. the math channel is not reliable
@@ -117,12 +117,13 @@ void MathChannel::calculate( DSOsamples &result ) {
             for ( auto dstIt = mathChannel.begin(), dstEnd = mathChannel.end(); dstIt != dstEnd; ++srcIt, ++dstIt )
                 *dstIt = sign * ( *srcIt * *srcIt );
         } else {
-            // calculate DC component of channel that's needed for some of the math functions...
-            double average = 0;
-            for ( auto srcIt = result.data[ src ].begin(), srcEnd = result.data[ src ].end(); srcIt != srcEnd; ++srcIt ) {
-                average += *srcIt;
-            }
-            average /= double( result.data[ src ].size() );
+            // DC component of channel that's needed for some of the math functions, known from the conversion
+            if ( result.statistics.size() <= src )
+                result.statistics.resize( src + 1 );
+            SampleStatistics &srcStatistics = result.statistics[ src ];
+            if ( !srcStatistics.isValidFor( result.data[ src ] ) )
+                srcStatistics.calculate( result.data[ src ] );
+            const double average = srcStatistics.average();
 
             // also needed for all math functions
             auto srcIt = result.data[ src ].begin();
@@ -204,4 +205,7 @@ void MathChannel::calculate( DSOsamples &result ) {
         }
     }
     result.mathVoltageUnit = mathModeUnit( mathMode );
+    if ( result.statistics.size() <= MATH )
+        result.statistics.resize( MATH + 1 );
+    result.statistics[ MATH ].calculate( mathChannel );
 }
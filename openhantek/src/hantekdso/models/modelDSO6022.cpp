@@ -49,7 +49,7 @@ static void initSpecifications( Dso::ControlSpecification &specification ) {
     // 20k, 40k, 50k, 64k, 100k, 200k, 400k, 500k, 1M, 2M, 3M, 4M, 5M, 6M, 8M, 10M, 12M, 15M, 16M, 24M, 30M (, 48M)
     // 48M is unusable in 1 channel mode due to massive USB overrun
     // 24M, 30M and 48M are unusable in 2 channel mode
-    // these unstable settings are disabled
+    // these unstable settings are disabled unless the continuous USB streaming is enabled (option "--streaming")
     // Lower effective sample rates < 10 MS/s use oversampling to increase the SNR
 
     specification.samplerate.single.base = 1e6;
@@ -58,6 +58,8 @@ static void initSpecifications( Dso::ControlSpecification &specification ) {
     specification.samplerate.multi.base = 1e6;
     specification.samplerate.multi.max = 15e6;
     specification.samplerate.multi.recordLengths = { UINT_MAX };
+    specification.samplerate.singleStreamingMax = 48e6;
+    specification.samplerate.multiStreamingMax = 24e6;
 
     specification.fixedSampleRates = {
         // samplerate, sampleId, downsampling
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "modelPLAYBACK.h"
+#include "hantekdsocontrol.h"
+#include "hantekprotocol/controlStructs.h"
+#include "modelregistry.h"
+#include "usb/scopedevice.h"
+
+using namespace Hantek;
+
+static ModelPLAYBACK modelInstance_PLAYBACK;
+
+static void initSpecifications( Dso::ControlSpecification &specification ) {
+    // The raw blocks of a recording (see RawRecorder) are replayed in real time or unthrottled,
+    // each block with its recorded channels, samplerate, oversampling and gain.
+    // The blocks contain the unstable samples at the start of the stream, they are skipped during the conversion
+    // as for a live device. Gain steps and scaling are those of the DSO-6022 unless the recording model is known.
+
+    // HW gain, voltage steps in V/div (ranges 20,50,100,200,500,1000,2000,5000 mV)
+    specification.gain = { { 10, 20e-3 }, { 10, 50e-3 }, { 10, 100e-3 }, { 5, 200e-3 },
+                           { 2, 500e-3 }, { 1, 1.00 },   { 1, 2.00 },    { 1, 5.00 } };
+
+    // Define the scaling between ADC sample values and real input voltage
+    // Everything is scaled on the full screen height (8 divs)
+    // The voltage/div setting:      20m   50m  100m  200m  500m    1V    2V    5V
+    // Equivalent input voltage:   0.16V  0.4V  0.8V  1.6V    4V    8V   16V   40V
+    // Theoretical gain setting:     x10   x10   x10   x5    x2     x1    x1    x1
+    // mV / digit:                     4     4     4     8    20    40    40    40
+    // The sample value for full screen (8 divs) with real gain setting of the DSO-6022
+    specification.voltageScale[ 0 ] = { 250, 250, 250, 126.25, 49.50, 24.75, 24.75, 24.75 };
+    specification.voltageScale[ 1 ] = { 250, 250, 250, 126.25, 49.50, 24.75, 24.75, 24.75 };
+
+    // All raw sample rates of the DSO-6022 firmware that can be found in a recording, there is no USB limit
+    // Lower effective sample rates < 10 MS/s use oversampling to increase the SNR as for the live device
+
+    specification.samplerate.single.base = 1e6;
+    specification.samplerate.single.max = 48e6; // allow all rates that could have been recorded (e.g. with --streaming)
+    specification.samplerate.single.recordLengths = { UINT_MAX };
+    specification.samplerate.multi.base = 1e6;
+    specification.samplerate.multi.max = 24e6;
+    specification.samplerate.multi.recordLengths = { UINT_MAX };
+
+    specification.fixedSampleRates = {
+        // samplerate, sampleId, downsampling
+        { 100, 102, 200 },  // very slow! 200x downsampling from 20 kS/s
+        { 200, 104, 200 },  // very slow! 200x downsampling from 40 kS/s
+        { 500, 110, 200 },  // very slow! 200x downsampling from 100 kS/s
+        { 1e3, 120, 200 },  // slow! 200x downsampling from 200 kS/s
+        { 2e3, 140, 200 },  // slow! 200x downsampling from 400 kS/s
+        { 5e3, 1, 200 },    // slow! 200x downsampling from 1 MS/s
+        { 10e3, 1, 100 },   // 100x downsampling from 1, 2, 5, 10 MS/s
+        { 20e3, 2, 100 },   //
+        { 50e3, 5, 100 },   //
+        { 100e3, 10, 100 }, //
+        { 200e3, 10, 50 },  // 50x, 20x 10x, 5x, 2x downsampling from 10 MS/s
+        { 500e3, 10, 20 },  //
+        { 1e6, 10, 10 },    //
+        { 2e6, 10, 5 },     //
+        { 5e6, 10, 2 },     //
+        { 10e6, 10, 1 },    // no oversampling
+        { 12e6, 12, 1 },    //
+        { 15e6, 15, 1 },    //
+        { 24e6, 24, 1 },    //
+        { 30e6, 30, 1 },    //
+        { 48e6, 48, 1 }     //
+    };
+
+    specification.couplings = { Dso::Coupling::DC, Dso::Coupling::AC };
+    specification.triggerModes = {
+        Dso::TriggerMode::AUTO,
+        Dso::TriggerMode::NORMAL,
+        Dso::TriggerMode::SINGLE,
+        Dso::TriggerMode::ROLL,
+    };
+    specification.fixedUSBinLength = 0;
+
+    // keep the calibration frequency spinbox of the recording device, it has no effect on the replay
+    specification.calfreqSteps = { 32,  40,   50,   60,   80,    100,   120,  160,   200,  250,  300,  400,
+                                   500, 600,  800,  1e3,  1.2e3, 1.6e3, 2e3,  2.5e3, 3e3,  4e3,  5e3,  6e3,
+                                   8e3, 10e3, 12e3, 16e3, 20e3,  25e3,  30e3, 40e3,  50e3, 60e3, 80e3, 100e3 };
+    specification.hasCalibrationEEPROM = true; // calibration values are provided by the recording
+    specification.isDemoDevice = true;
+}
+
+static void applyRequirements_( HantekDsoControl *dsoControl ) {
+    dsoControl->addCommand( new ControlSetGain_CH1() );    // 0xE0
+    dsoControl->addCommand( new ControlSetGain_CH2() );    // 0xE1
+    dsoControl->addCommand( new ControlSetSamplerate() );  // 0xE2
+    dsoControl->addCommand( new ControlStartSampling() );  // 0xE3
+    dsoControl->addCommand( new ControlSetNumChannels() ); // 0xE4
+    dsoControl->addCommand( new ControlSetCoupling() );    // 0xE5 (no effect w/o AC/DC HW mod)
+    dsoControl->addCommand( new ControlSetCalFreq() );     // 0xE6
+}
+
+
+// PLAYBACK of raw samples recorded with a Hantek DSO-6022BE/BL (see RawRecorder)
+// The samples are replayed with their recorded gain and samplerate settings
+//
+//                  VID/PID active  VID/PID no FW   FW ver  FW name     Scope name
+//                  |------------|  |------------|  |----|  |--------|  |--------|
+ModelPLAYBACK::ModelPLAYBACK()
+    : DSOModel( ID, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, "playback", "PLAYBACK", Dso::ControlSpecification( 2 ) ) {
+    initSpecifications( specification );
+}
+
+ModelPLAYBACK::ModelPLAYBACK( const QString &recordedModel ) : ModelPLAYBACK() {
+    for ( const DSOModel *model : ModelRegistry::get()->models() ) {
+        if ( model->ID != ID && model->name == recordedModel ) {
+            specification.gain = model->spec()->gain;
+            specification.voltageScale[ 0 ] = model->spec()->voltageScale[ 0 ];
+            specification.voltageScale[ 1 ] = model->spec()->voltageScale[ 1 ];
+            break;
+        }
+    }
+}
+
+void ModelPLAYBACK::applyRequirements( HantekDsoControl *dsoControl ) const { applyRequirements_( dsoControl ); }
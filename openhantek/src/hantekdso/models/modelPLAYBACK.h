@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "dsomodel.h"
+
+class HantekDsoControl;
+using namespace Hantek;
+
+const int PlaybackDeviceID = 0xDEDF;
+
+struct ModelPLAYBACK : public DSOModel {
+    static const int ID = PlaybackDeviceID;
+    ModelPLAYBACK();
+    /// Use the gain steps and the scaling of the recording model, if it is a known model
+    explicit ModelPLAYBACK( const QString &recordedModel );
+    void applyRequirements( HantekDsoControl *dsoControl ) const override;
+};
@@ -0,0 +1,423 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "rawkernel.h"
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __SSE2__ )
+#define RAWKERNEL_SSE2
+#include <emmintrin.h>
+#if defined( __GNUC__ )
+#define RAWKERNEL_AVX2
+#include <immintrin.h>
+#endif
+#elif defined( __aarch64__ ) && defined( __ARM_NEON )
+#define RAWKERNEL_NEON
+#include <arm_neon.h>
+#endif
+
+
+namespace RawKernel {
+
+typedef void ( *SumGroupsFunction )( const uint8_t *, unsigned, unsigned, unsigned, uint32_t *const[], ChannelStatistics[] );
+typedef void ( *MinMaxFunction )( const uint8_t *, unsigned, unsigned, unsigned, uint8_t &, uint8_t & );
+
+
+// Scalar code for the remaining values of a group that do not fill a vector register.
+// "pos" must point to a value of the 1st channel.
+static inline void sumTail( const uint8_t *in, unsigned pos, unsigned groupBytes, unsigned channels, uint32_t sum[ 2 ],
+                            uint8_t min[ 2 ], uint8_t max[ 2 ], uint64_t clipped[ 2 ] ) {
+    for ( ; pos < groupBytes; pos += channels ) {
+        for ( unsigned ch = 0; ch < channels; ++ch ) {
+            const uint8_t value = in[ pos + ch ];
+            sum[ ch ] += value;
+            min[ ch ] = value < min[ ch ] ? value : min[ ch ];
+            max[ ch ] = value > max[ ch ] ? value : max[ ch ];
+            clipped[ ch ] += value == 0x00 || value == 0xFF;
+        }
+    }
+}
+
+
+static void sumGroupsScalar( const uint8_t *data, unsigned channels, unsigned oversampling, unsigned groups,
+                             uint32_t *const sums[], ChannelStatistics statistics[] ) {
+    const unsigned groupBytes = oversampling * channels;
+    uint8_t min[ 2 ] = { statistics[ 0 ].min, statistics[ channels - 1 ].min };
+    uint8_t max[ 2 ] = { statistics[ 0 ].max, statistics[ channels - 1 ].max };
+    uint64_t total[ 2 ] = { 0, 0 };
+    uint64_t clipped[ 2 ] = { 0, 0 };
+    for ( unsigned group = 0; group < groups; ++group, data += groupBytes ) {
+        uint32_t sum[ 2 ] = { 0, 0 };
+        sumTail( data, 0, groupBytes, channels, sum, min, max, clipped );
+        for ( unsigned ch = 0; ch < channels; ++ch ) {
+            sums[ ch ][ group ] = sum[ ch ];
+            total[ ch ] += sum[ ch ];
+        }
+    }
+    for ( unsigned ch = 0; ch < channels; ++ch ) {
+        statistics[ ch ].min = min[ ch ];
+        statistics[ ch ].max = max[ ch ];
+        statistics[ ch ].sum += total[ ch ];
+        statistics[ ch ].clipped += clipped[ ch ];
+    }
+}
+
+
+// Scalar code for the values of one channel from byte position "pos" (a value of the 1st channel) up to "bytes".
+static inline void minMaxTail( const uint8_t *data, unsigned pos, unsigned bytes, unsigned channels, unsigned channel,
+                               uint8_t &min, uint8_t &max ) {
+    for ( pos += channel; pos < bytes; pos += channels ) {
+        const uint8_t value = data[ pos ];
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+    }
+}
+
+
+// The lanes of a vector of interleaved values that belong to the channel, "lanes" is a multiple of "channels".
+static inline void minMaxLanes( const uint8_t *vectorMin, const uint8_t *vectorMax, unsigned lanes, unsigned channels,
+                                unsigned channel, uint8_t &min, uint8_t &max ) {
+    for ( unsigned iii = channel; iii < lanes; iii += channels ) {
+        min = vectorMin[ iii ] < min ? vectorMin[ iii ] : min;
+        max = vectorMax[ iii ] > max ? vectorMax[ iii ] : max;
+    }
+}
+
+
+static void minMaxScalar( const uint8_t *data, unsigned channels, unsigned channel, unsigned count, uint8_t &min,
+                          uint8_t &max ) {
+    minMaxTail( data, 0, count * channels, channels, channel, min, max );
+}
+
+
+#ifdef RAWKERNEL_SSE2
+// psadbw against zero sums 8 bytes into one 64 bit lane, the odd bytes (CH2) are masked out for CH1 and vice versa.
+// All vector loads start at a group start (even offset), the even bytes belong always to CH1.
+static void sumGroupsSSE2( const uint8_t *data, unsigned channels, unsigned oversampling, unsigned groups,
+                           uint32_t *const sums[], ChannelStatistics statistics[] ) {
+    const unsigned groupBytes = oversampling * channels;
+    if ( groupBytes < 16 ) { // no full vector per group
+        sumGroupsScalar( data, channels, oversampling, groups, sums, statistics );
+        return;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi8( char( 0xFF ) );
+    const __m128i evenMask = _mm_set1_epi16( 0x00FF );
+    __m128i vMin = ones;
+    __m128i vMax = zero;
+    __m128i clip0 = zero; // 0xFF per clipped value, summed with psadbw
+    __m128i clip1 = zero;
+    uint8_t min[ 2 ] = { statistics[ 0 ].min, statistics[ channels - 1 ].min };
+    uint8_t max[ 2 ] = { statistics[ 0 ].max, statistics[ channels - 1 ].max };
+    uint64_t total[ 2 ] = { 0, 0 };
+    uint64_t clipped[ 2 ] = { 0, 0 };
+    for ( unsigned group = 0; group < groups; ++group, data += groupBytes ) {
+        __m128i acc0 = zero;
+        __m128i acc1 = zero;
+        unsigned pos = 0;
+        for ( ; pos + 16 <= groupBytes; pos += 16 ) {
+            const __m128i value = _mm_loadu_si128( reinterpret_cast< const __m128i * >( data + pos ) );
+            const __m128i clip = _mm_or_si128( _mm_cmpeq_epi8( value, zero ), _mm_cmpeq_epi8( value, ones ) );
+            vMin = _mm_min_epu8( vMin, value );
+            vMax = _mm_max_epu8( vMax, value );
+            if ( channels == 2 ) {
+                acc0 = _mm_add_epi64( acc0, _mm_sad_epu8( _mm_and_si128( value, evenMask ), zero ) );
+                acc1 = _mm_add_epi64( acc1, _mm_sad_epu8( _mm_srli_epi16( value, 8 ), zero ) );
+                clip0 = _mm_add_epi64( clip0, _mm_sad_epu8( _mm_and_si128( clip, evenMask ), zero ) );
+                clip1 = _mm_add_epi64( clip1, _mm_sad_epu8( _mm_srli_epi16( clip, 8 ), zero ) );
+            } else {
+                acc0 = _mm_add_epi64( acc0, _mm_sad_epu8( value, zero ) );
+                clip0 = _mm_add_epi64( clip0, _mm_sad_epu8( clip, zero ) );
+            }
+        }
+        uint32_t sum[ 2 ] = { uint32_t( _mm_cvtsi128_si32( acc0 ) + _mm_cvtsi128_si32( _mm_srli_si128( acc0, 8 ) ) ),
+                              uint32_t( _mm_cvtsi128_si32( acc1 ) + _mm_cvtsi128_si32( _mm_srli_si128( acc1, 8 ) ) ) };
+        sumTail( data, pos, groupBytes, channels, sum, min, max, clipped );
+        for ( unsigned ch = 0; ch < channels; ++ch ) {
+            sums[ ch ][ group ] = sum[ ch ];
+            total[ ch ] += sum[ ch ];
+        }
+    }
+    uint64_t clipLanes[ 2 ][ 2 ];
+    _mm_storeu_si128( reinterpret_cast< __m128i * >( clipLanes[ 0 ] ), clip0 );
+    _mm_storeu_si128( reinterpret_cast< __m128i * >( clipLanes[ 1 ] ), clip1 );
+    clipped[ 0 ] += ( clipLanes[ 0 ][ 0 ] + clipLanes[ 0 ][ 1 ] ) / 0xFF;
+    clipped[ 1 ] += ( clipLanes[ 1 ][ 0 ] + clipLanes[ 1 ][ 1 ] ) / 0xFF;
+    uint8_t vectorMin[ 16 ];
+    uint8_t vectorMax[ 16 ];
+    _mm_storeu_si128( reinterpret_cast< __m128i * >( vectorMin ), vMin );
+    _mm_storeu_si128( reinterpret_cast< __m128i * >( vectorMax ), vMax );
+    for ( unsigned iii = 0; iii < 16; ++iii ) {
+        const unsigned ch = iii % channels;
+        min[ ch ] = vectorMin[ iii ] < min[ ch ] ? vectorMin[ iii ] : min[ ch ];
+        max[ ch ] = vectorMax[ iii ] > max[ ch ] ? vectorMax[ iii ] : max[ ch ];
+    }
+    for ( unsigned ch = 0; ch < channels; ++ch ) {
+        statistics[ ch ].min = min[ ch ];
+        statistics[ ch ].max = max[ ch ];
+        statistics[ ch ].sum += total[ ch ];
+        statistics[ ch ].clipped += clipped[ ch ];
+    }
+}
+
+
+// Both channels are compared, the lanes of the other channel are ignored at the end.
+static void minMaxSSE2( const uint8_t *data, unsigned channels, unsigned channel, unsigned count, uint8_t &min,
+                        uint8_t &max ) {
+    const unsigned bytes = count * channels;
+    if ( bytes < 16 ) { // no full vector
+        minMaxScalar( data, channels, channel, count, min, max );
+        return;
+    }
+    __m128i vMin = _mm_set1_epi8( char( 0xFF ) );
+    __m128i vMax = _mm_setzero_si128();
+    unsigned pos = 0;
+    for ( ; pos + 16 <= bytes; pos += 16 ) {
+        const __m128i value = _mm_loadu_si128( reinterpret_cast< const __m128i * >( data + pos ) );
+        vMin = _mm_min_epu8( vMin, value );
+        vMax = _mm_max_epu8( vMax, value );
+    }
+    uint8_t vectorMin[ 16 ];
+    uint8_t vectorMax[ 16 ];
+    _mm_storeu_si128( reinterpret_cast< __m128i * >( vectorMin ), vMin );
+    _mm_storeu_si128( reinterpret_cast< __m128i * >( vectorMax ), vMax );
+    minMaxLanes( vectorMin, vectorMax, 16, channels, channel, min, max );
+    minMaxTail( data, pos, bytes, channels, channel, min, max );
+}
+#endif
+
+
+#ifdef RAWKERNEL_AVX2
+// Same as SSE2 with 32 byte vectors, compiled for AVX2 independent of the global compiler flags.
+__attribute__( ( target( "avx2" ) ) ) static void sumGroupsAVX2( const uint8_t *data, unsigned channels, unsigned oversampling,
+                                                                 unsigned groups, uint32_t *const sums[],
+                                                                 ChannelStatistics statistics[] ) {
+    const unsigned groupBytes = oversampling * channels;
+    if ( groupBytes < 32 ) { // no full vector per group
+        sumGroupsSSE2( data, channels, oversampling, groups, sums, statistics );
+        return;
+    }
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi8( char( 0xFF ) );
+    const __m256i evenMask = _mm256_set1_epi16( 0x00FF );
+    __m256i vMin = ones;
+    __m256i vMax = zero;
+    __m256i clip0 = zero; // 0xFF per clipped value, summed with vpsadbw
+    __m256i clip1 = zero;
+    uint8_t min[ 2 ] = { statistics[ 0 ].min, statistics[ channels - 1 ].min };
+    uint8_t max[ 2 ] = { statistics[ 0 ].max, statistics[ channels - 1 ].max };
+    uint64_t total[ 2 ] = { 0, 0 };
+    uint64_t clipped[ 2 ] = { 0, 0 };
+    for ( unsigned group = 0; group < groups; ++group, data += groupBytes ) {
+        __m256i acc0 = zero;
+        __m256i acc1 = zero;
+        unsigned pos = 0;
+        for ( ; pos + 32 <= groupBytes; pos += 32 ) {
+            const __m256i value = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( data + pos ) );
+            const __m256i clip = _mm256_or_si256( _mm256_cmpeq_epi8( value, zero ), _mm256_cmpeq_epi8( value, ones ) );
+            vMin = _mm256_min_epu8( vMin, value );
+            vMax = _mm256_max_epu8( vMax, value );
+            if ( channels == 2 ) {
+                acc0 = _mm256_add_epi64( acc0, _mm256_sad_epu8( _mm256_and_si256( value, evenMask ), zero ) );
+                acc1 = _mm256_add_epi64( acc1, _mm256_sad_epu8( _mm256_srli_epi16( value, 8 ), zero ) );
+                clip0 = _mm256_add_epi64( clip0, _mm256_sad_epu8( _mm256_and_si256( clip, evenMask ), zero ) );
+                clip1 = _mm256_add_epi64( clip1, _mm256_sad_epu8( _mm256_srli_epi16( clip, 8 ), zero ) );
+            } else {
+                acc0 = _mm256_add_epi64( acc0, _mm256_sad_epu8( value, zero ) );
+                clip0 = _mm256_add_epi64( clip0, _mm256_sad_epu8( clip, zero ) );
+            }
+        }
+        uint64_t lanes[ 2 ][ 4 ];
+        _mm256_storeu_si256( reinterpret_cast< __m256i * >( lanes[ 0 ] ), acc0 );
+        _mm256_storeu_si256( reinterpret_cast< __m256i * >( lanes[ 1 ] ), acc1 );
+        uint32_t sum[ 2 ] = { uint32_t( lanes[ 0 ][ 0 ] + lanes[ 0 ][ 1 ] + lanes[ 0 ][ 2 ] + lanes[ 0 ][ 3 ] ),
+                              uint32_t( lanes[ 1 ][ 0 ] + lanes[ 1 ][ 1 ] + lanes[ 1 ][ 2 ] + lanes[ 1 ][ 3 ] ) };
+        sumTail( data, pos, groupBytes, channels, sum, min, max, clipped );
+        for ( unsigned ch = 0; ch < channels; ++ch ) {
+            sums[ ch ][ group ] = sum[ ch ];
+            total[ ch ] += sum[ ch ];
+        }
+    }
+    uint64_t clipLanes[ 2 ][ 4 ];
+    _mm256_storeu_si256( reinterpret_cast< __m256i * >( clipLanes[ 0 ] ), clip0 );
+    _mm256_storeu_si256( reinterpret_cast< __m256i * >( clipLanes[ 1 ] ), clip1 );
+    clipped[ 0 ] += ( clipLanes[ 0 ][ 0 ] + clipLanes[ 0 ][ 1 ] + clipLanes[ 0 ][ 2 ] + clipLanes[ 0 ][ 3 ] ) / 0xFF;
+    clipped[ 1 ] += ( clipLanes[ 1 ][ 0 ] + clipLanes[ 1 ][ 1 ] + clipLanes[ 1 ][ 2 ] + clipLanes[ 1 ][ 3 ] ) / 0xFF;
+    uint8_t vectorMin[ 32 ];
+    uint8_t vectorMax[ 32 ];
+    _mm256_storeu_si256( reinterpret_cast< __m256i * >( vectorMin ), vMin );
+    _mm256_storeu_si256( reinterpret_cast< __m256i * >( vectorMax ), vMax );
+    for ( unsigned iii = 0; iii < 32; ++iii ) {
+        const unsigned ch = iii % channels;
+        min[ ch ] = vectorMin[ iii ] < min[ ch ] ? vectorMin[ iii ] : min[ ch ];
+        max[ ch ] = vectorMax[ iii ] > max[ ch ] ? vectorMax[ iii ] : max[ ch ];
+    }
+    for ( unsigned ch = 0; ch < channels; ++ch ) {
+        statistics[ ch ].min = min[ ch ];
+        statistics[ ch ].max = max[ ch ];
+        statistics[ ch ].sum += total[ ch ];
+        statistics[ ch ].clipped += clipped[ ch ];
+    }
+}
+
+
+__attribute__( ( target( "avx2" ) ) ) static void minMaxAVX2( const uint8_t *data, unsigned channels, unsigned channel,
+                                                              unsigned count, uint8_t &min, uint8_t &max ) {
+    const unsigned bytes = count * channels;
+    if ( bytes < 32 ) { // no full vector
+        minMaxSSE2( data, channels, channel, count, min, max );
+        return;
+    }
+    __m256i vMin = _mm256_set1_epi8( char( 0xFF ) );
+    __m256i vMax = _mm256_setzero_si256();
+    unsigned pos = 0;
+    for ( ; pos + 32 <= bytes; pos += 32 ) {
+        const __m256i value = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( data + pos ) );
+        vMin = _mm256_min_epu8( vMin, value );
+        vMax = _mm256_max_epu8( vMax, value );
+    }
+    uint8_t vectorMin[ 32 ];
+    uint8_t vectorMax[ 32 ];
+    _mm256_storeu_si256( reinterpret_cast< __m256i * >( vectorMin ), vMin );
+    _mm256_storeu_si256( reinterpret_cast< __m256i * >( vectorMax ), vMax );
+    minMaxLanes( vectorMin, vectorMax, 32, channels, channel, min, max );
+    minMaxTail( data, pos, bytes, channels, channel, min, max );
+}
+#endif
+
+
+#ifdef RAWKERNEL_NEON
+// 1 for each clipped value (0x00 or 0xFF), 0 otherwise
+static inline uint8x16_t clipMask( uint8x16_t value ) {
+    return vshrq_n_u8( vorrq_u8( vceqq_u8( value, vdupq_n_u8( 0x00 ) ), vceqq_u8( value, vdupq_n_u8( 0xFF ) ) ), 7 );
+}
+
+
+// vld2q_u8 deinterleaves CH1/CH2, the bytes are added pairwise into 16 bit and then into 32 bit lanes.
+static void sumGroupsNEON( const uint8_t *data, unsigned channels, unsigned oversampling, unsigned groups,
+                           uint32_t *const sums[], ChannelStatistics statistics[] ) {
+    const unsigned groupBytes = oversampling * channels;
+    if ( groupBytes < 32 ) { // no full vector per group
+        sumGroupsScalar( data, channels, oversampling, groups, sums, statistics );
+        return;
+    }
+    uint8x16_t vMin[ 2 ] = { vdupq_n_u8( 0xFF ), vdupq_n_u8( 0xFF ) };
+    uint8x16_t vMax[ 2 ] = { vdupq_n_u8( 0x00 ), vdupq_n_u8( 0x00 ) };
+    uint32x4_t clip[ 2 ] = { vdupq_n_u32( 0 ), vdupq_n_u32( 0 ) }; // number of clipped values
+    uint8_t min[ 2 ] = { statistics[ 0 ].min, statistics[ channels - 1 ].min };
+    uint8_t max[ 2 ] = { statistics[ 0 ].max, statistics[ channels - 1 ].max };
+    uint64_t total[ 2 ] = { 0, 0 };
+    uint64_t clipped[ 2 ] = { 0, 0 };
+    for ( unsigned group = 0; group < groups; ++group, data += groupBytes ) {
+        uint32x4_t acc0 = vdupq_n_u32( 0 );
+        uint32x4_t acc1 = vdupq_n_u32( 0 );
+        unsigned pos = 0;
+        for ( ; pos + 32 <= groupBytes; pos += 32 ) {
+            if ( channels == 2 ) {
+                const uint8x16x2_t value = vld2q_u8( data + pos );
+                vMin[ 0 ] = vminq_u8( vMin[ 0 ], value.val[ 0 ] );
+                vMax[ 0 ] = vmaxq_u8( vMax[ 0 ], value.val[ 0 ] );
+                vMin[ 1 ] = vminq_u8( vMin[ 1 ], value.val[ 1 ] );
+                vMax[ 1 ] = vmaxq_u8( vMax[ 1 ], value.val[ 1 ] );
+                acc0 = vpadalq_u16( acc0, vpaddlq_u8( value.val[ 0 ] ) );
+                acc1 = vpadalq_u16( acc1, vpaddlq_u8( value.val[ 1 ] ) );
+                clip[ 0 ] = vpadalq_u16( clip[ 0 ], vpaddlq_u8( clipMask( value.val[ 0 ] ) ) );
+                clip[ 1 ] = vpadalq_u16( clip[ 1 ], vpaddlq_u8( clipMask( value.val[ 1 ] ) ) );
+            } else {
+                const uint8x16_t value0 = vld1q_u8( data + pos );
+                const uint8x16_t value1 = vld1q_u8( data + pos + 16 );
+                vMin[ 0 ] = vminq_u8( vMin[ 0 ], vminq_u8( value0, value1 ) );
+                vMax[ 0 ] = vmaxq_u8( vMax[ 0 ], vmaxq_u8( value0, value1 ) );
+                acc0 = vpadalq_u16( acc0, vpaddlq_u8( value0 ) );
+                acc0 = vpadalq_u16( acc0, vpaddlq_u8( value1 ) );
+                clip[ 0 ] = vpadalq_u16( clip[ 0 ], vpaddlq_u8( vaddq_u8( clipMask( value0 ), clipMask( value1 ) ) ) );
+            }
+        }
+        uint32_t sum[ 2 ] = { vaddvq_u32( acc0 ), vaddvq_u32( acc1 ) };
+        sumTail( data, pos, groupBytes, channels, sum, min, max, clipped );
+        for ( unsigned ch = 0; ch < channels; ++ch ) {
+            sums[ ch ][ group ] = sum[ ch ];
+            total[ ch ] += sum[ ch ];
+        }
+    }
+    for ( unsigned ch = 0; ch < channels; ++ch ) {
+        const uint8_t vectorMin = vminvq_u8( vMin[ ch ] );
+        const uint8_t vectorMax = vmaxvq_u8( vMax[ ch ] );
+        statistics[ ch ].min = vectorMin < min[ ch ] ? vectorMin : min[ ch ];
+        statistics[ ch ].max = vectorMax > max[ ch ] ? vectorMax : max[ ch ];
+        statistics[ ch ].sum += total[ ch ];
+        statistics[ ch ].clipped += clipped[ ch ] + vaddvq_u32( clip[ ch ] );
+    }
+}
+
+
+static void minMaxNEON( const uint8_t *data, unsigned channels, unsigned channel, unsigned count, uint8_t &min,
+                        uint8_t &max ) {
+    const unsigned bytes = count * channels;
+    if ( bytes < 16 ) { // no full vector
+        minMaxScalar( data, channels, channel, count, min, max );
+        return;
+    }
+    uint8x16_t vMin = vdupq_n_u8( 0xFF );
+    uint8x16_t vMax = vdupq_n_u8( 0x00 );
+    unsigned pos = 0;
+    for ( ; pos + 16 <= bytes; pos += 16 ) {
+        const uint8x16_t value = vld1q_u8( data + pos );
+        vMin = vminq_u8( vMin, value );
+        vMax = vmaxq_u8( vMax, value );
+    }
+    uint8_t vectorMin[ 16 ];
+    uint8_t vectorMax[ 16 ];
+    vst1q_u8( vectorMin, vMin );
+    vst1q_u8( vectorMax, vMax );
+    minMaxLanes( vectorMin, vectorMax, 16, channels, channel, min, max );
+    minMaxTail( data, pos, bytes, channels, channel, min, max );
+}
+#endif
+
+
+struct Kernel {
+    SumGroupsFunction function;
+    MinMaxFunction minMax;
+    const char *name;
+};
+
+
+static Kernel selectKernel() {
+#ifdef RAWKERNEL_AVX2
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports( "avx2" ) )
+        return { sumGroupsAVX2, minMaxAVX2, "AVX2" };
+#endif
+#if defined( RAWKERNEL_SSE2 )
+    return { sumGroupsSSE2, minMaxSSE2, "SSE2" };
+#elif defined( RAWKERNEL_NEON )
+    return { sumGroupsNEON, minMaxNEON, "NEON" };
+#else
+    return { sumGroupsScalar, minMaxScalar, "scalar" };
+#endif
+}
+
+
+static const Kernel &kernel() {
+    static const Kernel selected = selectKernel(); // check the CPU features only once, thread safe
+    return selected;
+}
+
+
+void sumGroups( const uint8_t *data, unsigned channels, unsigned oversampling, unsigned groups, uint32_t *const sums[],
+                ChannelStatistics statistics[] ) {
+    if ( !groups || !oversampling || channels < 1 || channels > 2 )
+        return;
+    kernel().function( data, channels, oversampling, groups, sums, statistics );
+}
+
+
+void minMax( const uint8_t *data, unsigned channels, unsigned channel, unsigned count, uint8_t &min, uint8_t &max ) {
+    if ( !count || channels < 1 || channels > 2 || channel >= channels )
+        return;
+    kernel().minMax( data, channels, channel, count, min, max );
+}
+
+
+const char *kernelName() { return kernel().name; }
+
+} // namespace RawKernel
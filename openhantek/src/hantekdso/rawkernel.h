@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstdint>
+
+
+/// \brief Vectorized processing of the interleaved 8 bit raw ADC data.
+///
+/// The kernel is chosen once at runtime: AVX2 or SSE2 on x86, NEON on 64 bit ARM, scalar code otherwise.
+namespace RawKernel {
+
+/// \brief Statistics of all raw values of one channel, updated by sumGroups().
+struct ChannelStatistics {
+    uint8_t min = 0xFF;   ///< Smallest raw value, 0x00 -> clipped
+    uint8_t max = 0x00;   ///< Largest raw value, 0xFF -> clipped
+    uint64_t sum = 0;     ///< Sum of all raw values
+    uint64_t clipped = 0; ///< Number of clipped raw values (0x00 or 0xFF)
+};
+
+/// \brief Deinterleave the channels and sum groups of oversampled values in one pass.
+/// \param data Interleaved raw data CH1/CH2/CH1/..., groups * oversampling * channels bytes.
+/// \param channels The number of interleaved channels (1 or 2).
+/// \param oversampling The number of raw values per group and channel.
+/// \param groups The number of groups, i.e. resulting values per channel.
+/// \param sums Target for each channel, receives the sum of each group.
+/// \param statistics Min, max, sum and clip count of each channel, updated.
+void sumGroups( const uint8_t *data, unsigned channels, unsigned oversampling, unsigned groups, uint32_t *const sums[],
+                ChannelStatistics statistics[] );
+
+/// \brief Smallest and largest raw value of one channel, e.g. for a quick check before the conversion.
+/// \param data Interleaved raw data CH1/CH2/CH1/..., count * channels bytes.
+/// \param channels The number of interleaved channels (1 or 2).
+/// \param channel The channel to scan.
+/// \param count The number of values per channel.
+/// \param min, max Updated with the smallest and largest value.
+void minMax( const uint8_t *data, unsigned channels, unsigned channel, unsigned count, uint8_t &min, uint8_t &max );
+
+/// \brief The name of the kernel used on this CPU, e.g. "AVX2".
+const char *kernelName();
+
+} // namespace RawKernel
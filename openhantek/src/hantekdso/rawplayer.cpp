@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "rawplayer.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <cstring>
+
+
+bool RawPlayer::open( const QString &fileName ) {
+    close();
+    baseName = fileName;
+    if ( !openSegment( 0 ) )
+        return false;
+    firstSegment = segment = fileHeader.segment;
+    if ( segment ) { // a later segment was given, get the name of the 1st segment "name_0001.ohraw" -> "name.ohraw"
+        QFileInfo info( fileName );
+        QString name = info.completeBaseName();
+        name.chop( 5 ); // "_NNNN"
+        if ( !info.suffix().isEmpty() )
+            name += "." + info.suffix();
+        baseName = info.dir().filePath( name );
+    }
+    return true;
+}
+
+
+void RawPlayer::close() {
+    if ( map )
+        file.unmap( const_cast< uchar * >( map ) );
+    map = nullptr;
+    mapSize = 0;
+    position = 0;
+    if ( file.isOpen() )
+        file.close();
+}
+
+
+const RawBlockHeader *RawPlayer::nextBlock( const unsigned char *&data ) {
+    bool restarted = false;
+    while ( position + qint64( sizeof( RawBlockHeader ) ) > mapSize ) { // end of segment
+        if ( !openSegment( segment + 1 ) ) {                            // end of recording, start again
+            if ( restarted || !openSegment( firstSegment ) )            // no block at all
+                return nullptr;
+            restarted = true;
+        }
+    }
+    memcpy( &blockHeader, map + position, sizeof( RawBlockHeader ) ); // block headers are not aligned
+    position += sizeof( RawBlockHeader );
+    if ( position + blockHeader.size > mapSize ) { // truncated recording, e.g. program was killed
+        position = mapSize;
+        blockHeader.size = 0;
+        blockHeader.valid = 0;
+    }
+    data = map + position;
+    position += blockHeader.size;
+    ++blocksPlayed;
+    bytesPlayed += blockHeader.size;
+    return &blockHeader;
+}
+
+
+bool RawPlayer::openSegment( unsigned number ) {
+    close();
+    file.setFileName( RawRecorder::segmentFileName( baseName, number ) );
+    if ( !file.open( QIODevice::ReadOnly ) ) {
+        errorString = file.errorString();
+        return false;
+    }
+    mapSize = file.size();
+    if ( mapSize >= qint64( sizeof( RawFileHeader ) ) )
+        map = file.map( 0, mapSize );
+    if ( !map ) {
+        errorString = QCoreApplication::translate( "RawPlayer", "Not a raw sample file" );
+        close();
+        return false;
+    }
+    memcpy( &fileHeader, map, sizeof( RawFileHeader ) );
+    if ( strncmp( fileHeader.magic, RAW_FILE_MAGIC, sizeof( fileHeader.magic ) ) || fileHeader.version != RAW_FILE_VERSION ||
+         fileHeader.headerSize < sizeof( RawFileHeader ) || fileHeader.blockHeaderSize != sizeof( RawBlockHeader ) ) {
+        errorString = QCoreApplication::translate( "RawPlayer", "Unsupported raw sample file format" );
+        qWarning() << "RawPlayer:" << file.fileName() << errorString;
+        close();
+        return false;
+    }
+    fileHeader.model[ sizeof( fileHeader.model ) - 1 ] = '\0'; // the model name is used as a string
+    segment = number;
+    position = fileHeader.headerSize;
+    return true;
+}
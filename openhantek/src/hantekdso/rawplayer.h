@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "rawrecorder.h"
+
+#include <QFile>
+#include <QString>
+
+
+/// \brief Replays a raw sample recording made by RawRecorder block by block.
+/// The segment files are memory mapped read-only, after the last block the replay starts again with the 1st block.
+class RawPlayer {
+  public:
+    ~RawPlayer() { close(); }
+
+    /// \brief Open a recording.
+    /// \param fileName Name of the 1st available segment file.
+    /// \return true if the file is a valid recording.
+    bool open( const QString &fileName );
+    void close();
+
+    /// \brief The header of the recording with model name and calibration values.
+    const RawFileHeader &getFileHeader() const { return fileHeader; }
+
+    /// \brief Get the next recorded block.
+    /// \param data Set to the samples of the block, valid until the next call.
+    /// \return The header of the block or nullptr if the recording contains no block.
+    const RawBlockHeader *nextBlock( const unsigned char *&data );
+
+    unsigned getBlocksPlayed() const { return blocksPlayed; }
+    qint64 getBytesPlayed() const { return bytesPlayed; }
+    QString getErrorString() const { return errorString; }
+
+  private:
+    bool openSegment( unsigned number );
+    QString baseName;          // name of segment 0
+    unsigned firstSegment = 0; // 1st available segment, older segments may be removed (ring)
+    unsigned segment = 0;      // current segment
+    QFile file;
+    const uchar *map = nullptr;
+    qint64 mapSize = 0;
+    qint64 position = 0;
+    RawFileHeader fileHeader;
+    RawBlockHeader blockHeader;
+    unsigned blocksPlayed = 0;
+    qint64 bytesPlayed = 0;
+    QString errorString;
+};
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "rawqueue.h"
+
+
+RawQueue::RawQueue( unsigned size ) : size( size < 3 ? 3 : size ), blocks( new Slot[ size < 3 ? 3 : size ] ) {}
+
+
+Raw *RawQueue::writeBlock() {
+    if ( writing ) // still filling the last block
+        return writing;
+    // 1st choice: a free slot
+    for ( unsigned iii = 0; iii < size; ++iii ) {
+        if ( stateOf( blocks[ iii ].word.load( std::memory_order_acquire ) ) == FREE ) { // only the producer leaves FREE
+            blocks[ iii ].word.store( pack( 0, WRITING ), std::memory_order_relaxed );
+            writingBlock = &blocks[ iii ];
+            return writing = &writingBlock->raw;
+        }
+    }
+    if ( !everyBlock.load( std::memory_order_relaxed ) ) {
+        // 2nd choice: reuse the oldest unread block, the consumer wants only the newest one
+        for ( ;; ) {
+            Slot *oldest = nullptr;
+            uint64_t oldestWord = UINT64_MAX;
+            for ( unsigned iii = 0; iii < size; ++iii ) {
+                const uint64_t word = blocks[ iii ].word.load( std::memory_order_acquire );
+                if ( stateOf( word ) == READY && sequenceOf( word ) < sequenceOf( oldestWord ) ) {
+                    oldest = &blocks[ iii ];
+                    oldestWord = word;
+                }
+            }
+            if ( !oldest ) // the consumer has taken or released the blocks meanwhile
+                return writeBlock();
+            if ( oldest->word.compare_exchange_strong( oldestWord, pack( 0, WRITING ), std::memory_order_acq_rel ) ) {
+                dropped.fetch_add( 1, std::memory_order_relaxed );
+                writingBlock = oldest;
+                return writing = &writingBlock->raw;
+            }
+        }
+    }
+    // every block mode and queue full: keep the unread blocks, this block will be dropped
+    writingBlock = nullptr;
+    return writing = &spare;
+}
+
+
+void RawQueue::commitBlock() {
+    if ( !writing )
+        return;
+    if ( writingBlock ) {
+        writingBlock->word.store( pack( nextSequence++, READY ), std::memory_order_release ); // publish the block content
+    } else {
+        dropped.fetch_add( 1, std::memory_order_relaxed );
+    }
+    writing = nullptr;
+    writingBlock = nullptr;
+}
+
+
+const Raw *RawQueue::readBlock() {
+    const bool newest = !everyBlock.load( std::memory_order_relaxed );
+    for ( ;; ) {
+        Slot *candidate = nullptr;
+        uint64_t candidateWord = 0;
+        uint64_t candidateSequence = newest ? 0 : UINT64_MAX;
+        // the slots are not checked at once, a block published during the scan can hide an older block that was still
+        // being written when its slot was checked. Every block mode: scan again until the oldest block is confirmed,
+        // a scan after the candidate was found sees all blocks published before it
+        uint64_t previousSequence;
+        do {
+            previousSequence = candidateSequence;
+            for ( unsigned iii = 0; iii < size; ++iii ) {
+                const uint64_t word = blocks[ iii ].word.load( std::memory_order_acquire );
+                if ( stateOf( word ) != READY )
+                    continue;
+                const uint64_t sequence = sequenceOf( word );
+                if ( newest ? sequence > candidateSequence : sequence < candidateSequence ) {
+                    candidate = &blocks[ iii ];
+                    candidateWord = word;
+                    candidateSequence = sequence;
+                }
+            }
+        } while ( !newest && candidateSequence != previousSequence );
+        if ( !candidate ) // nothing new, keep the current block
+            return readingBlock ? &readingBlock->raw : nullptr;
+        if ( !candidate->word.compare_exchange_strong( candidateWord, pack( candidateSequence, READING ),
+                                                       std::memory_order_acq_rel ) )
+            continue; // reused by the producer meanwhile, search again
+        if ( readingBlock ) // give the last block back to the producer
+            readingBlock->word.store( pack( 0, FREE ), std::memory_order_release );
+        readingBlock = candidate;
+        if ( newest ) { // drop all older unread blocks, a block republished meanwhile has a newer sequence and stays
+            for ( unsigned iii = 0; iii < size; ++iii ) {
+                uint64_t word = blocks[ iii ].word.load( std::memory_order_acquire );
+                if ( stateOf( word ) == READY && sequenceOf( word ) < candidateSequence &&
+                     blocks[ iii ].word.compare_exchange_strong( word, pack( 0, FREE ), std::memory_order_acq_rel ) )
+                    dropped.fetch_add( 1, std::memory_order_relaxed );
+            }
+        }
+        return &readingBlock->raw;
+    }
+}
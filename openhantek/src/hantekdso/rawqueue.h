@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+/// \brief One block of raw ADC samples together with the settings used for its acquisition.
+struct Raw {
+    unsigned channels = 0;
+    double samplerate = 0;
+    unsigned oversampling = 0;
+    unsigned gainValue[ 2 ] = { 1, 1 }; // 1,2,5,10,..
+    unsigned gainIndex[ 2 ] = { 7, 7 }; // index 0..7
+    unsigned tag = 0;
+    bool freeRun = false;  // small buffer, no trigger
+    bool valid = false;    // samples can be processed
+    bool rollMode = false; // one complete buffer received, start to roll
+    unsigned size = 0;
+    unsigned received = 0;
+    int64_t timeStart = 0; // steady clock time of the transfer start in ns (see steadyTime())
+    int64_t timeEnd = 0;   // steady clock time of the transfer end in ns
+    std::vector< unsigned char > data;
+};
+
+
+/// \brief Bounded lock-free single producer / single consumer queue of preallocated raw blocks.
+///
+/// The producer (CapturingThread) fills the block returned by writeBlock() and publishes it with commitBlock().
+/// The consumer (HantekDsoControl) gets the newest or - in every block mode - the oldest unread block with readBlock(),
+/// this block stays valid and unchanged until the next readBlock() call that returns a different block.
+/// The producer never waits for the consumer:
+/// - newest mode: if there is no free block the oldest published but not yet read block is reused.
+/// - every block mode: if there is no free block the new block is written into a spare block and dropped.
+/// The data vectors keep their capacity, i.e. the blocks are allocated only once for the biggest size.
+class RawQueue {
+  public:
+    /// \param size Number of blocks in the queue, at least 3 (one for writing, one for reading, one ready).
+    explicit RawQueue( unsigned size = 3 );
+
+    /// \brief Producer: get the block that shall be filled, it is not visible to the consumer before commitBlock().
+    Raw *writeBlock();
+
+    /// \brief Producer: publish the block returned by writeBlock().
+    void commitBlock();
+
+    /// \brief Consumer: get the block to process, older unread blocks are dropped if not in every block mode.
+    /// \return The new block if one was published since the last call, else the last block (nullptr before the 1st block).
+    const Raw *readBlock();
+
+    /// \brief Consumer: process every block (true) or only the newest block (false, default).
+    void setEveryBlock( bool every ) { everyBlock.store( every, std::memory_order_relaxed ); }
+    bool isEveryBlock() const { return everyBlock.load( std::memory_order_relaxed ); }
+
+    /// \brief Number of blocks that were dropped by the producer (every block mode) or consumer (newest mode).
+    unsigned getDropped() const { return dropped.load( std::memory_order_relaxed ); }
+
+  private:
+    enum State { FREE, WRITING, READY, READING };
+    /// state and publishing order (valid in state READY) are packed into one word, i.e. a compare and swap fails also
+    /// if the slot was reused and published again meanwhile with the same state but a newer sequence number (ABA)
+    struct Slot {
+        Raw raw;
+        std::atomic< uint64_t > word{ FREE };
+    };
+    static uint64_t pack( uint64_t sequence, State state ) { return sequence << 2 | state; }
+    static State stateOf( uint64_t word ) { return State( word & 3 ); }
+    static uint64_t sequenceOf( uint64_t word ) { return word >> 2; }
+    const unsigned size;
+    std::unique_ptr< Slot[] > blocks;
+    Raw spare;                    ///< every block mode: written if the queue is full, never published
+    Raw *writing = nullptr;       ///< producer: the block returned by writeBlock()
+    Slot *writingBlock = nullptr; ///< producer: the slot of this block or nullptr for the spare block
+    uint64_t nextSequence = 1;    ///< producer: sequence number for the next published block
+    Slot *readingBlock = nullptr; ///< consumer: the slot returned by readBlock()
+    std::atomic< bool > everyBlock{ false };
+    std::atomic< unsigned > dropped{ 0 };
+};
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "rawrecorder.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStorageInfo>
+#include <cstring>
+#if defined Q_OS_LINUX || defined Q_OS_FREEBSD
+#include <cerrno>
+#include <fcntl.h>
+#endif
+
+
+bool RawRecorder::start( const QString &fileName, const QString &model, const Hantek::CalibrationValues &calibration,
+                         const Hantek::CalibrationValues &correction, unsigned maxSegments, qint64 segmentSize ) {
+    stop();
+    QMutexLocker locker( &mutex );
+    memset( &fileHeader, 0, sizeof( fileHeader ) );
+    strncpy( fileHeader.magic, RAW_FILE_MAGIC, sizeof( fileHeader.magic ) );
+    fileHeader.version = RAW_FILE_VERSION;
+    fileHeader.headerSize = sizeof( RawFileHeader );
+    fileHeader.blockHeaderSize = sizeof( RawBlockHeader );
+    strncpy( fileHeader.model, model.toLatin1().constData(), sizeof( fileHeader.model ) - 1 );
+    fileHeader.calibration = calibration;
+    fileHeader.correction = correction;
+    baseName = fileName;
+    this->maxSegments = maxSegments;
+    this->segmentSize = segmentSize;
+    segment = 0;
+    bytesWritten = 0;
+    errorString.clear();
+    if ( !openSegment( 0 ) )
+        return false;
+    elapsed.start();
+    recording = true;
+    return true;
+}
+
+
+void RawRecorder::stop() {
+    QMutexLocker locker( &mutex );
+    recording = false;
+    closeSegment();
+}
+
+
+bool RawRecorder::write( RawBlockHeader &header, const unsigned char *data ) {
+    QMutexLocker locker( &mutex );
+    if ( !recording ) // stopped meanwhile
+        return true;
+    if ( !header.valid ) // mark the gap, but do not store the invalid samples
+        header.size = 0;
+    header.time = elapsed.nsecsElapsed();
+    const qint64 blockSize = qint64( sizeof( RawBlockHeader ) ) + header.size;
+    if ( position + blockSize > mapSize ) { // segment full, continue with the next one
+        closeSegment();
+        ++segment;
+        if ( !openSegment( blockSize ) ) {
+            recording = false;
+            return false;
+        }
+    }
+    memcpy( map + position, &header, sizeof( RawBlockHeader ) );
+    position += sizeof( RawBlockHeader );
+    if ( header.size ) {
+        memcpy( map + position, data, header.size );
+        position += header.size;
+    }
+    bytesWritten += blockSize;
+    return true;
+}
+
+
+QString RawRecorder::getErrorString() const {
+    QMutexLocker locker( &mutex );
+    return errorString;
+}
+
+
+QString RawRecorder::segmentFileName( const QString &fileName, unsigned segment ) {
+    if ( 0 == segment )
+        return fileName;
+    QFileInfo info( fileName );
+    QString name = info.completeBaseName() + QString( "_%1" ).arg( segment, 4, 10, QChar( '0' ) );
+    if ( !info.suffix().isEmpty() )
+        name += "." + info.suffix();
+    return info.dir().filePath( name );
+}
+
+
+bool RawRecorder::openSegment( qint64 minSize ) {
+    if ( maxSegments && segment >= maxSegments ) // ring of segments, remove the oldest one
+        QFile::remove( segmentFileName( baseName, segment - maxSegments ) );
+    file.setFileName( segmentFileName( baseName, segment ) );
+    errorString.clear();
+    mapSize = qMax( segmentSize, qint64( sizeof( RawFileHeader ) ) + minSize );
+    // the blocks of the mapped file must be reserved, writing into a hole of a sparse file on a full disk raises SIGBUS
+    if ( !file.open( QIODevice::ReadWrite | QIODevice::Truncate ) || !file.resize( mapSize ) || !reserveSegment() ||
+         nullptr == ( map = file.map( 0, mapSize ) ) ) {
+        if ( errorString.isEmpty() )
+            errorString = file.errorString();
+        qWarning() << "RawRecorder: cannot create" << file.fileName() << errorString;
+        if ( file.isOpen() ) // do not leave a segment without header
+            file.remove();
+        file.close();
+        map = nullptr;
+        mapSize = 0;
+        return false;
+    }
+    fileHeader.segment = segment;
+    memcpy( map, &fileHeader, sizeof( RawFileHeader ) );
+    position = sizeof( RawFileHeader );
+    bytesWritten += position;
+    return true;
+}
+
+
+bool RawRecorder::reserveSegment() {
+#if defined Q_OS_LINUX || defined Q_OS_FREEBSD
+    const int error = posix_fallocate( file.handle(), 0, mapSize );
+    if ( 0 == error )
+        return true;
+    if ( EINVAL != error && EOPNOTSUPP != error ) { // the file system cannot allocate, check the free space instead
+        errorString = QString::fromLocal8Bit( strerror( error ) );
+        return false;
+    }
+#endif
+    // resize() allocates the blocks on Windows, other systems may create a sparse file
+    QStorageInfo storage( file.fileName() );
+    if ( storage.isValid() && storage.bytesAvailable() < mapSize ) {
+        errorString = QCoreApplication::translate( "RawRecorder", "Not enough free disk space" );
+        return false;
+    }
+    return true;
+}
+
+
+void RawRecorder::closeSegment() {
+    if ( !file.isOpen() )
+        return;
+    if ( map )
+        file.unmap( map );
+    map = nullptr;
+    file.resize( position ); // truncate the reserved but unused end of the segment
+    file.close();
+    mapSize = 0;
+    position = 0;
+}
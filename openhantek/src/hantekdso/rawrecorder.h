@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "hantekprotocol/definitions.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <stdint.h>
+
+#define RAW_FILE_MAGIC "OpenHantekRaw"
+#define RAW_FILE_VERSION 1
+#define RAW_SEGMENT_SIZE ( qint64( 256 ) * 1024 * 1024 ) // default size of one segment file
+
+
+#pragma pack( push, 1 )
+
+// Raw sample file layout, all values in host byte order (little endian):
+// RawFileHeader, then for every captured block a RawBlockHeader followed by "size" interleaved ADC bytes
+// CH1/CH2/CH1/CH2/... (or CH1/CH1/... for one channel), exactly as received from the scope.
+// A long recording is split into segment files "name.ohraw", "name_0001.ohraw", "name_0002.ohraw", ...
+
+struct RawFileHeader {
+    char magic[ 16 ];                      ///< RAW_FILE_MAGIC
+    uint32_t version;                      ///< RAW_FILE_VERSION
+    uint32_t headerSize;                   ///< sizeof( RawFileHeader )
+    uint32_t blockHeaderSize;              ///< sizeof( RawBlockHeader )
+    uint32_t segment;                      ///< number of this segment file, 0 = 1st file
+    char model[ 32 ];                      ///< model name of the scope, zero terminated
+    Hantek::CalibrationValues calibration; ///< calibration bytes (EEPROM or ini file)
+    Hantek::CalibrationValues correction;  ///< offset and gain corrections, encoded as calibration bytes
+};
+
+struct RawBlockHeader {
+    uint32_t size;          ///< number of sample bytes following this header, 0 = gap in recording
+    uint32_t tag;           ///< tag of the captured block
+    double samplerate;      ///< ADC sample rate
+    uint16_t oversampling;  ///< raw samples per effective sample
+    uint8_t channels;       ///< 1 or 2 interleaved channels
+    uint8_t valid;          ///< 0 if the block is incomplete (gap)
+    uint8_t gainValue[ 2 ]; ///< 1,2,5,10,..
+    uint8_t gainIndex[ 2 ]; ///< index 0..7
+    int64_t time;           ///< ns since start of recording, end of the capture of this block
+};
+
+#pragma pack( pop )
+
+
+/// \brief Records the raw ADC stream without any conversion into memory mapped segment files.
+/// The sample data is copied directly into the mapped file, the OS writes it out in the background.
+/// Optionally only the last maxSegments files are kept, i.e. the segments are used as a ring.
+/// All functions are thread safe, write() is called from the CapturingThread.
+class RawRecorder {
+  public:
+    ~RawRecorder() { stop(); }
+
+    /// \brief Start a new recording.
+    /// \param fileName Name of the 1st segment file.
+    /// \param model Model name of the scope.
+    /// \param calibration Calibration values used for the conversion.
+    /// \param correction Offset and gain corrections.
+    /// \param maxSegments Keep only the last maxSegments files, 0 = keep all.
+    /// \param segmentSize Size of one segment file in bytes.
+    /// \return true if the 1st segment file was created.
+    bool start( const QString &fileName, const QString &model, const Hantek::CalibrationValues &calibration,
+                const Hantek::CalibrationValues &correction, unsigned maxSegments = 0, qint64 segmentSize = RAW_SEGMENT_SIZE );
+
+    /// \brief Finish the recording, the last segment file is truncated to the used size.
+    void stop();
+
+    bool isRecording() const { return recording.load( std::memory_order_relaxed ); }
+
+    /// \brief Append one block to the recording, a block with valid == 0 marks a gap and its samples are omitted.
+    /// \return false if the recording was stopped due to an error.
+    bool write( RawBlockHeader &header, const unsigned char *data );
+
+    qint64 getBytesWritten() const { return bytesWritten.load( std::memory_order_relaxed ); }
+    QString getErrorString() const;
+
+    /// \brief Name of the segment file with the given number.
+    static QString segmentFileName( const QString &fileName, unsigned segment );
+
+  private:
+    bool openSegment( qint64 minSize );
+    bool reserveSegment();
+    void closeSegment();
+    mutable QMutex mutex;
+    std::atomic< bool > recording{ false };
+    std::atomic< qint64 > bytesWritten{ 0 };
+    QString errorString;
+    QFile file;
+    RawFileHeader fileHeader;
+    QString baseName;
+    unsigned maxSegments = 0;
+    qint64 segmentSize = RAW_SEGMENT_SIZE;
+    unsigned segment = 0;  // number of the current segment file
+    uchar *map = nullptr;  // memory mapped segment file
+    qint64 mapSize = 0;    // size of the mapped file
+    qint64 position = 0;   // write position in the mapped file
+    QElapsedTimer elapsed; // time since start of recording
+};
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "samplestatistics.h"
+
+#include <algorithm>
+
+
+void SampleStatistics::clear() {
+    min = 0.0;
+    max = 0.0;
+    sum = 0.0;
+    sumSquares = 0.0;
+    count = 0;
+    clipped = 0;
+    blockMin.clear();
+    blockMax.clear();
+}
+
+
+void SampleStatistics::addBlock( const Sample *samples, unsigned blockCount ) {
+    if ( !blockCount )
+        return;
+    Sample minimum = samples[ 0 ];
+    Sample maximum = samples[ 0 ];
+    double blockSum = 0.0;
+    double blockSquares = 0.0;
+    for ( unsigned index = 0; index < blockCount; ++index ) {
+        const Sample value = samples[ index ];
+        minimum = value < minimum ? value : minimum;
+        maximum = value > maximum ? value : maximum;
+        blockSum += value;
+        blockSquares += double( value ) * value;
+    }
+    if ( !count || minimum < min )
+        min = minimum;
+    if ( !count || maximum > max )
+        max = maximum;
+    sum += blockSum;
+    sumSquares += blockSquares;
+    count += blockCount;
+    blockMin.push_back( minimum );
+    blockMax.push_back( maximum );
+}
+
+
+void SampleStatistics::calculate( const std::vector< Sample > &samples ) {
+    const uint64_t keepClipped = clipped;
+    clear();
+    clipped = keepClipped;
+    const size_t size = samples.size();
+    blockMin.reserve( ( size + BLOCK_SIZE - 1 ) / BLOCK_SIZE );
+    blockMax.reserve( ( size + BLOCK_SIZE - 1 ) / BLOCK_SIZE );
+    for ( size_t first = 0; first < size; first += BLOCK_SIZE )
+        addBlock( samples.data() + first, unsigned( std::min( size - first, size_t( BLOCK_SIZE ) ) ) );
+}
+
+
+void SampleStatistics::windowMinMax( const std::vector< Sample > &samples, size_t first, size_t last, double &minimum,
+                                     double &maximum ) const {
+    if ( samples.empty() || first >= samples.size() || first > last ) {
+        minimum = maximum = 0.0;
+        return;
+    }
+    last = std::min( last, samples.size() - 1 );
+    Sample lo = samples[ first ];
+    Sample hi = samples[ first ];
+    auto scan = [ & ]( size_t from, size_t to ) { // samples [from, to)
+        for ( size_t index = from; index < to; ++index ) {
+            lo = samples[ index ] < lo ? samples[ index ] : lo;
+            hi = samples[ index ] > hi ? samples[ index ] : hi;
+        }
+    };
+    const size_t firstBlock = ( first + BLOCK_SIZE - 1 ) / BLOCK_SIZE; // 1st complete block in window
+    const size_t endBlock = ( last + 1 ) / BLOCK_SIZE;                 // behind the last complete block in window
+    if ( !isValidFor( samples ) || firstBlock >= endBlock ) {          // no block values or no complete block
+        scan( first, last + 1 );
+    } else {
+        scan( first, firstBlock * BLOCK_SIZE );
+        for ( size_t block = firstBlock; block < endBlock; ++block ) {
+            lo = blockMin[ block ] < lo ? blockMin[ block ] : lo;
+            hi = blockMax[ block ] > hi ? blockMax[ block ] : hi;
+        }
+        scan( endBlock * BLOCK_SIZE, last + 1 );
+    }
+    minimum = lo;
+    maximum = hi;
+}
+
+
+double SampleStatistics::acSquare() const {
+    if ( !count )
+        return 0.0;
+    const double dc = average();
+    return std::max( sumSquares / double( count ) - dc * dc, 0.0 ); // no negative rounding errors
+}
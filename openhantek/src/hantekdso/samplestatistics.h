@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "hantekprotocol/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/// \brief Statistics of the samples of one channel, calculated in the same pass that writes the samples.
+///
+/// Besides the values of the complete frame the min / max of each block of BLOCK_SIZE samples is kept,
+/// so the min / max of any window (e.g. the displayed part of the trace) needs only the block values
+/// and the few samples of the partial blocks at the window edges.
+class SampleStatistics {
+  public:
+    static const unsigned BLOCK_SIZE = 64;
+
+    /// \brief Start a new frame, the block buffers keep their capacity.
+    void clear();
+
+    /// \brief Add the next block of samples, all blocks except the last one must have BLOCK_SIZE samples.
+    void addBlock( const Sample *samples, unsigned count );
+
+    /// \brief Calculate the statistics of a complete frame in one pass, e.g. for the math channel.
+    void calculate( const std::vector< Sample > &samples );
+
+    /// \brief The statistics belong to these samples (same frame, all samples added).
+    bool isValidFor( const std::vector< Sample > &samples ) const { return count && count == samples.size(); }
+
+    /// \brief Get min and max of the samples [first, last], the same samples that were used for the statistics.
+    void windowMinMax( const std::vector< Sample > &samples, size_t first, size_t last, double &minimum,
+                       double &maximum ) const;
+
+    double average() const { return count ? sum / double( count ) : 0.0; }
+    /// \brief The mean of the squared AC component, i.e. the square of the AC rms value.
+    double acSquare() const;
+
+    double min = 0.0;        ///< The smallest sample of the frame
+    double max = 0.0;        ///< The largest sample of the frame
+    double sum = 0.0;        ///< The sum of all samples
+    double sumSquares = 0.0; ///< The sum of all squared samples
+    size_t count = 0;        ///< The number of samples, 0 -> not calculated
+    uint64_t clipped = 0;    ///< The number of clipped raw values (input channels, roll mode: new values only)
+
+  private:
+    std::vector< Sample > blockMin; ///< min of each block of BLOCK_SIZE samples
+    std::vector< Sample > blockMax; ///< max of each block of BLOCK_SIZE samples
+};
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "segmentpool.h"
+
+#include <algorithm>
+
+
+void SegmentPool::request( unsigned count ) {
+    this->count.store( std::max( count, 1u ), std::memory_order_relaxed );
+    filled.store( 0, std::memory_order_relaxed );
+    state.store( REQUESTED, std::memory_order_release );
+}
+
+
+void SegmentPool::cancel() {
+    int expected = REQUESTED; // nothing captured yet
+    if ( state.compare_exchange_strong( expected, IDLE, std::memory_order_acq_rel ) )
+        return;
+    // keep the filled segments, the producer ignores the segment it is writing
+    // complete first: if the producer has completed the sequence meanwhile, its count stays valid
+    if ( expected == CAPTURING && state.compare_exchange_strong( expected, COMPLETE, std::memory_order_acq_rel ) )
+        count.store( filled.load( std::memory_order_acquire ), std::memory_order_release );
+}
+
+
+void SegmentPool::release() {
+    int expected = COMPLETE;
+    state.compare_exchange_strong( expected, IDLE, std::memory_order_acq_rel );
+}
+
+
+Raw *SegmentPool::nextSegment( unsigned blockSize ) {
+    int current = state.load( std::memory_order_acquire );
+    if ( current == REQUESTED ) { // allocate all segments before the 1st capture
+        unsigned segmentCount = count.load( std::memory_order_relaxed );
+        if ( blockSize && size_t( segmentCount ) * blockSize > SEGMENT_MEMORY_MAX ) {
+            segmentCount = unsigned( std::max( SEGMENT_MEMORY_MAX / blockSize, size_t( 1 ) ) );
+            count.store( segmentCount, std::memory_order_relaxed );
+        }
+        if ( segments.size() < segmentCount )
+            segments.resize( segmentCount );
+        for ( unsigned iii = 0; iii < segmentCount; ++iii )
+            segments[ iii ].data.reserve( blockSize );
+        filled.store( 0, std::memory_order_relaxed );
+        if ( !state.compare_exchange_strong( current, CAPTURING, std::memory_order_acq_rel ) )
+            return nullptr; // cancelled or requested again meanwhile
+    } else if ( current != CAPTURING ) {
+        return nullptr;
+    }
+    return &segments[ filled.load( std::memory_order_relaxed ) ];
+}
+
+
+void SegmentPool::commitSegment() {
+    if ( state.load( std::memory_order_acquire ) != CAPTURING ) // requested again meanwhile, start from scratch
+        return;
+    unsigned segmentsFilled = filled.load( std::memory_order_relaxed ) + 1;
+    filled.store( segmentsFilled, std::memory_order_release );
+    if ( segmentsFilled >= count.load( std::memory_order_relaxed ) ) {
+        int expected = CAPTURING; // a new request() or cancel() meanwhile has precedence
+        state.compare_exchange_strong( expected, COMPLETE, std::memory_order_acq_rel );
+    }
+}
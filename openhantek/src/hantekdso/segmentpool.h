@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "rawqueue.h"
+
+#include <atomic>
+#include <vector>
+
+
+/// \brief Pool of raw blocks for the segmented (sequence) acquisition.
+///
+/// The consumer (HantekDsoControl) requests a sequence of N blocks with request().
+/// The producer (CapturingThread) allocates all segments before the 1st block is captured, fills them one after
+/// the other as fast as possible with nextSegment() / commitSegment() and marks the sequence as complete after the
+/// last block. The consumer accesses the segments only when the sequence is complete, no locking is needed.
+/// The data vectors keep their capacity, a new sequence of the same size needs no further allocation.
+class SegmentPool {
+  public:
+    enum State { IDLE, REQUESTED, CAPTURING, COMPLETE };
+
+    /// \brief Consumer: request a new sequence, a sequence still running is restarted.
+    /// \param count The number of blocks, limited by SEGMENT_MEMORY_MAX.
+    void request( unsigned count );
+
+    /// \brief Consumer: finish a running sequence early, the already captured segments are kept.
+    /// A segment that is filled meanwhile is discarded.
+    void cancel();
+
+    /// \brief Consumer: release the segments of a complete sequence, e.g. when normal sampling continues.
+    void release();
+
+    /// \brief Producer: get the next segment to fill, allocates the pool with the 1st call after request().
+    /// \param blockSize The size of the raw block in bytes.
+    /// \return The segment or nullptr if no sequence is running.
+    Raw *nextSegment( unsigned blockSize );
+
+    /// \brief Producer: the segment returned by nextSegment() is filled.
+    void commitSegment();
+
+    State getState() const { return State( state.load( std::memory_order_acquire ) ); }
+    bool isActive() const { return getState() == REQUESTED || getState() == CAPTURING; }
+    bool isComplete() const { return getState() == COMPLETE; }
+
+    /// \brief The number of captured segments, the sequence is complete if equal to getCount().
+    unsigned getFilled() const { return filled.load( std::memory_order_acquire ); }
+    unsigned getCount() const { return count.load( std::memory_order_relaxed ); }
+
+    /// \brief Consumer: access a segment of a complete sequence.
+    const Raw &segment( unsigned index ) const { return segments[ index ]; }
+
+  private:
+    static const size_t SEGMENT_MEMORY_MAX = size_t( 1 ) << 30; // do not allocate more than 1 GB
+    std::vector< Raw > segments;
+    std::atomic< int > state{ IDLE };
+    std::atomic< unsigned > count{ 0 };
+    std::atomic< unsigned > filled{ 0 };
+};
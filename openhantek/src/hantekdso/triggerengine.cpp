@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "triggerengine.h"
+#include "rawkernel.h"
+
+#include <algorithm>
+
+
+namespace {
+
+// Comparator with hysteresis, reports the crossings of the level in both directions
+struct Crossing {
+    Crossing( double level, double hysteresis ) : level( level ), hysteresis( hysteresis ) {}
+
+    // +1: rising crossing, -1: falling crossing at this sample, 0: none
+    int update( double value ) {
+        int event = 0;
+        if ( below && value >= level ) {
+            event = 1;
+            below = false;
+        } else if ( above && value <= level ) {
+            event = -1;
+            above = false;
+        }
+        if ( value < level - hysteresis )
+            below = true;
+        if ( value > level + hysteresis )
+            above = true;
+        return event;
+    }
+
+    const double level;
+    const double hysteresis;
+    bool below = false; // armed for a rising crossing
+    bool above = false; // armed for a falling crossing
+};
+
+
+// runt, window and slew rate need also the crossings of the 2nd level
+bool usesHighLevel( Dso::TriggerType type ) {
+    return type == Dso::TriggerType::Runt || type == Dso::TriggerType::WindowEnter || type == Dso::TriggerType::WindowExit ||
+           type == Dso::TriggerType::SlewRate;
+}
+
+} // namespace
+
+
+// every trigger event needs a crossing of the level (or of the 2nd level), a rising crossing needs a value
+// below level - hysteresis and a value at or above level, a falling crossing the mirrored values
+// static
+bool TriggerEngine::mayTrigger( const uint8_t *data, unsigned channels, unsigned channel, unsigned count, double offset,
+                                double scale, const Settings &settings ) {
+    uint8_t min = 0xFF;
+    uint8_t max = 0x00;
+    RawKernel::minMax( data, channels, channel, count, min, max );
+    if ( !scale || min > max ) // no valid conversion or no data, let the trigger search decide
+        return true;
+    // code positions in the direction of rising voltage, an inverted channel has a negative scale
+    const double sign = scale > 0 ? 1.0 : -1.0;
+    auto code = [ & ]( double voltage ) { return sign * ( offset + voltage / scale ); };
+    // the converted (averaged) samples are within [min, max], widened by half a step for the rounding of the samples
+    const double lowest = std::min( sign * min, sign * max ) - 0.5;
+    const double highest = std::max( sign * min, sign * max ) + 0.5;
+    auto crossable = [ & ]( double level ) {
+        const double threshold = code( level );
+        return ( lowest < code( level - settings.hysteresis ) && highest >= threshold ) ||
+               ( highest > code( level + settings.hysteresis ) && lowest <= threshold );
+    };
+    return crossable( settings.level ) || ( usesHighLevel( settings.type ) && crossable( settings.level + settings.height ) );
+}
+
+
+// the samples at position - 1 and position are on different sides of the level, interpolate linearly between them
+// static
+double TriggerEngine::crossingOffset( const std::vector< Sample > &samples, int position, double level ) {
+    if ( position < 1 || size_t( position ) >= samples.size() )
+        return 0.0;
+    const double before = samples[ size_t( position - 1 ) ];
+    const double after = samples[ size_t( position ) ];
+    if ( after == before )
+        return 0.0;
+    return std::min( std::max( ( after - level ) / ( after - before ), 0.0 ), 0.999999 );
+}
+
+
+// static
+TriggerEngine::Result TriggerEngine::search( const std::vector< Sample > &samples, const std::vector< double > &prefixSum,
+                                             int begin, int end, const Settings &settings, std::vector< Result > *events ) {
+    Result result;
+    const int count = int( samples.size() );
+    end = std::min( end, count );
+    if ( begin < 1 || begin >= end )
+        return result;
+
+    const bool rising = settings.slope != Dso::Slope::Negative;
+    const bool falling = settings.slope != Dso::Slope::Positive;
+    const double lowLevel = settings.level;
+    const double highLevel = settings.level + settings.height;
+    Crossing low( lowLevel, settings.hysteresis );
+    Crossing high( highLevel, settings.hysteresis );
+    const bool useHigh = usesHighLevel( settings.type );
+
+    const int average = std::max( settings.average, 1 );
+    const bool useMeans = average > 1 && prefixSum.size() > size_t( count );
+    // edge: the mean of the samples before the crossing is on the start side, the mean after on the end side
+    auto meansValid = [ & ]( int position, int direction ) {
+        double before = samples[ size_t( position - 1 ) ];
+        double after = position + 1 < count ? samples[ size_t( position + 1 ) ] : samples[ size_t( position ) ];
+        if ( useMeans ) {
+            int first = std::max( position - average, 0 );
+            before = ( prefixSum[ size_t( position ) ] - prefixSum[ size_t( first ) ] ) / ( position - first );
+            const int last = std::min( position + average + 1, count );
+            if ( last > position + 1 )
+                after = ( prefixSum[ size_t( last ) ] - prefixSum[ size_t( position + 1 ) ] ) / ( last - position - 1 );
+        }
+        return direction * before < direction * lowLevel && direction * after > direction * lowLevel;
+    };
+    auto timeMatches = [ & ]( double time ) {
+        switch ( settings.condition ) {
+        case Dso::TriggerCondition::Less:
+            return time < settings.time1;
+        case Dso::TriggerCondition::Greater:
+            return time > settings.time1;
+        case Dso::TriggerCondition::Within:
+            return time >= settings.time1 && time <= settings.time2;
+        }
+        return false;
+    };
+
+    double start = -1;          // pulse width, slew rate, timeout: exact time of the starting event, < 0: none
+    double fallStart = -1;      // slew rate: start of a falling transition
+    bool runtUp = false;        // runt: a positive pulse crossed the level but not yet the 2nd level
+    bool runtDown = false;      // runt: a negative pulse crossed the 2nd level but not yet the level
+    int edgeDirection = 0;      // edge: direction of the trigger crossing, searching the following crossings
+    double lastEdge = 0.0;      // edge: exact time of the last found crossing
+    int edgesFound = 0;         // edge: trigger + following crossings
+    const int edgeEnd = count - average - 1;
+
+    for ( int position = 1; position < count; ++position ) {
+        const double value = samples[ size_t( position ) ];
+        const int lowEvent = low.update( value );
+        const int highEvent = useHigh ? high.update( value ) : 0;
+        if ( !lowEvent && !highEvent && settings.type != Dso::TriggerType::Timeout )
+            continue;
+        const double lowTime = lowEvent ? position - crossingOffset( samples, position, lowLevel ) : 0.0;
+        const double highTime = highEvent ? position - crossingOffset( samples, position, highLevel ) : 0.0;
+        double event = -1; // exact time of a trigger event at this sample
+        switch ( settings.type ) {
+        case Dso::TriggerType::Edge: {
+            const bool trigger = position >= begin && position < end &&
+                                 ( ( lowEvent > 0 && rising ) || ( lowEvent < 0 && falling ) ) && meansValid( position, lowEvent );
+            if ( edgesFound ) { // triggered, search the following opposite and same crossing for the pulse widths
+                const int expected = edgesFound == 1 ? -edgeDirection : edgeDirection;
+                if ( edgesFound < 3 && position < edgeEnd && lowEvent == expected && meansValid( position, expected ) ) {
+                    ( edgesFound == 1 ? result.width1 : result.width2 ) = lowTime - lastEdge;
+                    lastEdge = lowTime;
+                    ++edgesFound;
+                }
+            } else if ( trigger ) {
+                result.position = position;
+                result.offset = position - lowTime;
+                edgeDirection = lowEvent;
+                lastEdge = lowTime;
+                edgesFound = 1;
+            }
+            if ( trigger && events ) {
+                Result found;
+                found.position = position;
+                found.offset = position - lowTime;
+                events->push_back( found );
+            }
+            const bool widthsDone = edgesFound == 3 || ( edgesFound && position >= edgeEnd );
+            if ( widthsDone && ( !events || position >= end ) )
+                return result;
+            continue;
+        }
+        case Dso::TriggerType::PulseWidth:
+            if ( lowEvent ) {
+                if ( start >= 0 && timeMatches( lowTime - start ) ) { // the pulse ends with the opposite crossing
+                    event = lowTime;
+                    result.width1 = lowTime - start;
+                }
+                start = ( lowEvent > 0 && rising ) || ( lowEvent < 0 && falling ) ? lowTime : -1; // next pulse
+            }
+            break;
+        case Dso::TriggerType::Runt: // rising crossings first, a big step can cross both levels
+            if ( lowEvent > 0 )
+                runtUp = rising;
+            if ( highEvent > 0 ) {
+                if ( runtDown )
+                    event = highTime; // negative pulse back over the 2nd level without crossing the level
+                runtUp = runtDown = false;
+            }
+            if ( highEvent < 0 )
+                runtDown = falling;
+            if ( lowEvent < 0 ) {
+                if ( runtUp )
+                    event = lowTime; // positive pulse back under the level without crossing the 2nd level
+                runtUp = runtDown = false;
+            }
+            break;
+        case Dso::TriggerType::WindowEnter: // from below over the level or from above under the 2nd level
+            if ( lowEvent > 0 && rising )
+                event = lowTime;
+            else if ( highEvent < 0 && falling )
+                event = highTime;
+            break;
+        case Dso::TriggerType::WindowExit: // up over the 2nd level or down under the level
+            if ( highEvent > 0 && rising )
+                event = highTime;
+            else if ( lowEvent < 0 && falling )
+                event = lowTime;
+            break;
+        case Dso::TriggerType::SlewRate: // time from level to 2nd level (rising) or from 2nd level to level (falling)
+            if ( lowEvent > 0 )
+                start = rising ? lowTime : -1;
+            if ( highEvent > 0 ) {
+                if ( start >= 0 && timeMatches( highTime - start ) ) {
+                    event = highTime;
+                    result.width1 = highTime - start;
+                }
+                start = fallStart = -1;
+            }
+            if ( highEvent < 0 )
+                fallStart = falling ? highTime : -1;
+            if ( lowEvent < 0 ) {
+                if ( fallStart >= 0 && timeMatches( lowTime - fallStart ) ) {
+                    event = lowTime;
+                    result.width1 = lowTime - fallStart;
+                }
+                start = fallStart = -1;
+            }
+            break;
+        case Dso::TriggerType::Timeout: // the state after the crossing lasts longer than time 1
+            if ( lowEvent )
+                start = ( lowEvent > 0 && rising ) || ( lowEvent < 0 && falling ) ? lowTime : -1;
+            else if ( start >= 0 && position - start >= settings.time1 ) {
+                event = start + settings.time1;
+                start = -1; // trigger only once for each state
+            }
+            break;
+        }
+        if ( event >= 0 && position >= begin ) {
+            if ( position >= end )
+                break;
+            result.position = position;
+            result.offset = std::min( std::max( position - event, 0.0 ), 0.999999 );
+            if ( !events )
+                return result;
+            events->push_back( result );
+        }
+        result.width1 = 0.0;
+    }
+    if ( edgesFound )
+        return result;
+    if ( events && !events->empty() )
+        return events->front();
+    return Result(); // not triggered
+}
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "enums.h"
+#include "hantekprotocol/types.h"
+#include <cstdint>
+#include <vector>
+
+
+/// \brief Single pass software trigger for edge, pulse width, runt, window, slew rate and timeout events.
+///
+/// The samples of one frame are scanned once by a state machine that follows the crossings of the trigger level
+/// and - for runt, window and slew rate - of the 2nd level "level + height", the cost is O(n) for all trigger types.
+/// A crossing counts only if the signal was below level - hysteresis (rising) or above level + hysteresis (falling)
+/// since the last crossing in the same direction. All event times are interpolated between the samples.
+class TriggerEngine {
+  public:
+    struct Settings {
+        Dso::TriggerType type = Dso::TriggerType::Edge;
+        Dso::Slope slope = Dso::Slope::Positive;                          ///< Polarity, Both: any polarity
+        Dso::TriggerCondition condition = Dso::TriggerCondition::Greater; ///< Pulse width and slew rate
+        double level = 0.0;                                               ///< Trigger level (V)
+        double height = 0.0;                                              ///< 2nd level = level + height (V)
+        double hysteresis = 0.0;                                          ///< (V)
+        double time1 = 0.0;                                               ///< Time condition in samples
+        double time2 = 0.0;                                               ///< Upper limit of "within" in samples
+        int average = 1; ///< Edge: the means of the samples before and after the crossing must be on both sides
+    };
+
+    struct Result {
+        int position = 0;    ///< The 1st sample after the trigger event, 0: not triggered
+        double offset = 0.0; ///< The exact event is at position - offset, [0, 1)
+        double width1 = 0.0; ///< Edge: the following pulse, pulse width and slew rate: the measured time, in samples
+        double width2 = 0.0; ///< Edge: the pulse after the following pulse in samples
+    };
+
+    /// \brief Search the 1st trigger event that happens at a sample in [begin, end).
+    /// \param samples The samples of the trigger channel.
+    /// \param prefixSum The running sum of the samples, prefixSum[ i ] = sum of [0, i), used for average > 1.
+    /// \param begin, end The range for the trigger event, the samples before begin are scanned too.
+    /// \param events If not null, all trigger events in [begin, end) are appended (position and offset, the pulse widths
+    /// only for pulse width and slew rate), the result is the 1st event.
+    static Result search( const std::vector< Sample > &samples, const std::vector< double > &prefixSum, int begin, int end,
+                          const Settings &settings, std::vector< Result > *events = nullptr );
+
+    /// \brief Quick check on the raw ADC codes of the trigger channel before the frame is converted.
+    /// The levels are mapped to code thresholds with the calibrated conversion voltage = ( code - offset ) * scale and
+    /// compared with the smallest and largest code of the channel (vectorized scan). The order of the values is ignored,
+    /// i.e. a frame without trigger event may pass, but a frame with a possible trigger event is never rejected.
+    /// \param data Interleaved raw data, starts with a value of CH1.
+    /// \param channels, channel The number of interleaved channels and the trigger channel.
+    /// \param count The number of values per channel.
+    /// \return false if the frame cannot trigger.
+    static bool mayTrigger( const uint8_t *data, unsigned channels, unsigned channel, unsigned count, double offset, double scale,
+                            const Settings &settings );
+
+    /// \brief Sub-sample distance of the level crossing between position - 1 and position, [0, 1).
+    static double crossingOffset( const std::vector< Sample > &samples, int position, double level );
+};
@@ -13,136 +13,89 @@ Triggering::Triggering( const DsoSettingsScope *scope, const Dso::ControlSetting
 }
 
 
-// search for trigger point from defined point, default startPos = 0;
-// return trigger position > 0 (0: no trigger found)
-int Triggering::searchTriggerPoint( DSOsamples &result, Dso::Slope dsoSlope, int startPos ) {
-    int slope;
-    if ( dsoSlope == Dso::Slope::Positive )
-        slope = 1;
-    else if ( dsoSlope == Dso::Slope::Negative )
-        slope = -1;
-    else
-        return 0;
-
-    unsigned channel = unsigned( controlsettings.trigger.source );
-    const std::vector< double > &samples = result.data[ channel ];
-    int sampleCount = int( samples.size() ); ///< number of available samples
-    if ( startPos < 0 || startPos >= sampleCount )
-        return 0;
-    double triggerLevel = controlsettings.trigger.level[ channel ];
-    if ( scope->verboseLevel > 5 )
-        qDebug() << "     Triggering::searchTriggerPoint()" << channel << triggerLevel << slope << startPos;
-    int samplesDisplay = int( round( controlsettings.samplerate.target.duration * controlsettings.samplerate.current ) );
-    int searchBegin;
-    int searchEnd;
-    if ( 0 == startPos ) {                                                      // search 1st trigger slope
-        searchBegin = int( controlsettings.trigger.position * samplesDisplay ); // samples left of trigger
-        searchEnd = sampleCount - ( int( samplesDisplay ) - searchBegin );      // samples right of trigger
-    } else {                                                                    // search next slopes for duty cycle
-        searchBegin = startPos;                                                 // search from start point ..
-        searchEnd = sampleCount;                                                // .. up to end of samples
-    }
-    // Two possible search scenarios:
-    // 1. search for the trigger slope that allows stable trace display (omit pre and post trigger area)
-    // |-----------samples-----------| // available sample
-    // |--disp--|                      // display size
-    // |<<<<<T>>|--------------------| // >> = right = (disp-pre) i.e. right of trigger on screen
-    // |<pre<|                         // << = left = pre
-    // |--(samp-(disp-pre))-------|>>|
-    // |<<<<<|????????????????????|>>| // ?? = search for trigger in this range [left,right]
-    // 2. search duty cycle slopes without need for stable display margins
-    // |<<<<<T???????????????????????| // ?? = search for other (duty cycle) slopes in this range
-
-    const int triggerAverage = int( pow( 20, controlsettings.trigger.smooth ) ); // smooth 0,1,2 -> 1,20,400
-    if ( searchBegin < triggerAverage )
-        searchBegin = triggerAverage;
-    if ( searchEnd >= sampleCount - triggerAverage )
-        searchEnd = sampleCount - triggerAverage - 1;
-    if ( scope->verboseLevel > 5 )
-        qDebug() << "     begin:" << searchBegin << "end:" << searchEnd;
-
-    double prev = INT_MAX;
-    int swTriggerStart = 0;
-    for ( int i = searchBegin; i < searchEnd; i++ ) {
-        if ( slope * samples[ size_t( i ) ] >= slope * triggerLevel &&
-             slope * prev < slope * triggerLevel ) { // trigger condition met
-            // check for the previous few SampleSet samples, if they are also above/below the trigger value
-            // use different averaging sizes for HF, normal and LF signals
-            bool triggerBefore = false;
-            double mean = 0;
-            int iii = 0;
-            for ( int k = i - 1; k >= i - triggerAverage && k >= 0; k-- ) {
-                mean += samples[ size_t( k ) ];
-                iii++;
-            }
-            if ( iii ) {
-                mean /= iii;
-                triggerBefore = slope * mean < slope * triggerLevel;
-            }
-            // check for the next few SampleSet samples, if they are also above/below the trigger value
-            bool triggerAfter = false;
-            if ( triggerBefore ) { // search right side only if left side condition is met
-                mean = 0;
-                iii = 0;
-                for ( int k = i + 1; k <= i + triggerAverage && k < sampleCount; k++ ) {
-                    mean += samples[ size_t( k ) ];
-                    iii++;
-                }
-                if ( iii ) {
-                    mean /= iii;
-                    triggerAfter = slope * mean > slope * triggerLevel;
-                }
-            }
-            // if at least triggerAverage samples before and after trig meet the condition, set trigger
-            if ( triggerBefore && triggerAfter ) {
-                swTriggerStart = i;
-                break;
-            }
-        }
-        prev = samples[ size_t( i ) ];
-    }
-    if ( scope->verboseLevel > 5 )
-        qDebug() << "     swT:" << swTriggerStart;
-    return swTriggerStart;
-} // Triggering::searchTriggerPoint()
-
-
 int Triggering::searchTriggeredPosition( DSOsamples &result ) {
-    static Dso::Slope nextSlope = Dso::Slope::Positive; // for alternating slope mode X
     ChannelID channel = ChannelID( controlsettings.trigger.source );
+    result.triggerEvents.clear();
     // Trigger channel not in use
     if ( !scope->anyUsed( channel ) || result.data.empty() || result.data[ channel ].empty() )
         return result.triggeredPosition = 0;
     if ( scope->verboseLevel > 4 )
         qDebug() << "    Triggering::searchTriggeredPosition()" << result.tag;
     triggeredPositionRaw = 0;
+    double triggerOffset = 0.0;
     double pulseWidth1 = 0.0;
     double pulseWidth2 = 0.0;
 
-    size_t sampleCount = result.data[ channel ].size();              // number of available samples
+    const std::vector< Sample > &samples = result.data[ channel ];
+    int sampleCount = int( samples.size() );                         // number of available samples
     double timeDisplay = controlsettings.samplerate.target.duration; // time for full screen width
     double sampleRate = result.samplerate;                           //
-    unsigned samplesDisplay = unsigned( round( timeDisplay * controlsettings.samplerate.current ) );
-    if ( sampleCount < samplesDisplay ) // not enough samples to adjust for jitter.
+    int samplesDisplay = int( round( timeDisplay * controlsettings.samplerate.current ) );
+    if ( sampleCount < samplesDisplay ) { // not enough samples to adjust for jitter.
+        result.triggerOffset = 0.0;
         return result.triggeredPosition = 0;
+    }
     // search for trigger point in a range that leaves enough samples left and right of trigger for display
-    // find also up to two alternating slopes after trigger point -> calculate pulse widths and duty cycle.
+    // |-----------samples-----------| // available sample
+    // |--disp--|                      // display size
+    // |<<<<<T>>|--------------------| // >> = right = (disp-pre) i.e. right of trigger on screen
+    // |<pre<|                         // << = left = pre
+    // |--(samp-(disp-pre))-------|>>|
+    // |<<<<<|????????????????????|>>| // ?? = search for trigger in this range [left,right]
+    // edge trigger: find also up to two alternating slopes after trigger point -> pulse widths and duty cycle.
+    int searchBegin = int( controlsettings.trigger.position * samplesDisplay ); // samples left of trigger
+    int searchEnd = sampleCount - ( samplesDisplay - searchBegin );             // samples right of trigger
+    const int triggerAverage = int( pow( 20, controlsettings.trigger.smooth ) ); // smooth 0,1,2 -> 1,20,400
+    if ( searchBegin < triggerAverage )
+        searchBegin = triggerAverage;
+    if ( searchEnd >= sampleCount - triggerAverage )
+        searchEnd = sampleCount - triggerAverage - 1;
+    if ( scope->verboseLevel > 5 )
+        qDebug() << "     begin:" << searchBegin << "end:" << searchEnd;
+
     if ( controlsettings.trigger.slope != Dso::Slope::Both ) // up or down
         nextSlope = controlsettings.trigger.slope;           // use this slope
+    const bool edge = controlsettings.trigger.type == Dso::TriggerType::Edge;
 
-    triggeredPositionRaw = searchTriggerPoint( result, nextSlope ); // get 1st slope position
-    if ( triggeredPositionRaw ) { // triggered -> search also following other slope (calculate pulse width)
-        if ( int slopePos2 = searchTriggerPoint( result, mirrorSlope( nextSlope ), triggeredPositionRaw ) ) {
-            pulseWidth1 = ( slopePos2 - triggeredPositionRaw ) / sampleRate;
-            if ( int slopePos3 = searchTriggerPoint( result, nextSlope, slopePos2 ) ) { // search 3rd slope
-                pulseWidth2 = ( slopePos3 - slopePos2 ) / sampleRate;
-            }
-        }
-        if ( controlsettings.trigger.slope == Dso::Slope::Both ) // trigger found and alternating?
-            nextSlope = mirrorSlope( nextSlope );                // use opposite direction next time
+    // running sum of the trigger channel for the averages around the edge crossings
+    if ( edge && triggerAverage > 1 ) {
+        prefixSum.resize( size_t( sampleCount ) + 1 );
+        double sum = 0.0;
+        prefixSum[ 0 ] = sum;
+        for ( size_t index = 0; index < size_t( sampleCount ); ++index )
+            prefixSum[ index + 1 ] = sum += samples[ index ];
+    }
+
+    // all trigger types in one pass over the samples
+    TriggerEngine::Settings settings;
+    settings.type = controlsettings.trigger.type;
+    settings.slope = edge ? nextSlope : controlsettings.trigger.slope; // edge: alternating slopes in mode "Both"
+    settings.condition = controlsettings.trigger.condition;
+    settings.level = controlsettings.trigger.level[ channel ];
+    settings.height = controlsettings.trigger.height;
+    settings.hysteresis = controlsettings.trigger.hysteresis;
+    settings.time1 = controlsettings.trigger.time1 * sampleRate;
+    settings.time2 = controlsettings.trigger.time2 * sampleRate;
+    settings.average = edge ? triggerAverage : 1;
+    // multi trigger: each event of the block provides an aligned trace, limited to keep the graph generation fast
+    // (the traces are drawn only in TY format)
+    const bool multiTrigger = controlsettings.trigger.multiTrigger;
+    events.clear();
+    const TriggerEngine::Result found =
+        TriggerEngine::search( samples, prefixSum, searchBegin, searchEnd, settings, multiTrigger ? &events : nullptr );
+    for ( size_t index = 0; index < events.size() && index < MULTI_TRIGGER_MAX; ++index )
+        result.triggerEvents.push_back( events[ index ].position - events[ index ].offset );
+    triggeredPositionRaw = found.position;
+    if ( triggeredPositionRaw ) { // the interpolated event time gives a jitter free display and pulse width
+        triggerOffset = found.offset;
+        pulseWidth1 = found.width1 / sampleRate;
+        pulseWidth2 = found.width2 / sampleRate;
+        if ( edge && controlsettings.trigger.slope == Dso::Slope::Both ) // trigger found and alternating?
+            nextSlope = mirrorSlope( nextSlope );                        // use opposite direction next time
     }
 
     result.triggeredPosition = triggeredPositionRaw; // align trace to trigger position
+    result.triggerOffset = triggerOffset;
     result.pulseWidth1 = pulseWidth1;
     result.pulseWidth2 = pulseWidth2;
     if ( scope->verboseLevel > 5 ) // HACK: This assumes that positive=0 and negative=1
@@ -152,29 +105,67 @@ int Triggering::searchTriggeredPosition( DSOsamples &result ) {
 } // Triggering::searchTriggeredPosition()
 
 
+bool Triggering::mayTrigger( const uint8_t *data, unsigned channels, unsigned count, double offset, double scale ) const {
+    const unsigned channel = unsigned( controlsettings.trigger.source );
+    if ( channel >= channels ) // MATH or channel not sampled
+        return true;
+    TriggerEngine::Settings settings;
+    settings.type = controlsettings.trigger.type;
+    settings.level = controlsettings.trigger.level[ channel ];
+    settings.height = controlsettings.trigger.height;
+    settings.hysteresis = controlsettings.trigger.hysteresis;
+    return TriggerEngine::mayTrigger( data, channels, channel, count, offset, scale, settings );
+}
+
+
 bool Triggering::provideTriggeredData( DSOsamples &result ) {
     if ( scope->verboseLevel > 4 )
         qDebug() << "    Triggering::provideTriggeredData()" << result.tag;
-    static DSOsamples triggeredResult; // storage for last triggered trace samples
-    if ( result.triggeredPosition ) {  // live trace has triggered
-        // Use this trace and save it also
-        triggeredResult.data = result.data;
+    // the sample buffers are never copied, only swapped between result and the storage:
+    // while result shows the last triggered trace (resultHoldsTriggered) the storage keeps the spare buffers
+    if ( result.triggeredPosition ) { // live trace has triggered
+        // Use this trace and save it also, the buffers stay in result until the next conversion
         triggeredResult.samplerate = result.samplerate;
         triggeredResult.clipped = result.clipped;
         triggeredResult.triggeredPosition = result.triggeredPosition;
+        triggeredResult.triggerOffset = result.triggerOffset;
+        resultHoldsTriggered = true;
         result.liveTrigger = true;
     } else if ( controlsettings.trigger.mode == Dso::TriggerMode::NORMAL ) { // Not triggered in NORMAL mode
-        // Use saved trace (even if it is empty)
-        result.data = triggeredResult.data;
+        // Use saved trace (even if it is empty), the untriggered buffers become the spare buffers
+        if ( !resultHoldsTriggered ) {
+            swapBuffers( result );
+            resultHoldsTriggered = true;
+        }
         result.samplerate = triggeredResult.samplerate;
         result.clipped = triggeredResult.clipped;
         result.triggeredPosition = triggeredResult.triggeredPosition;
+        result.triggerOffset = triggeredResult.triggerOffset;
         result.liveTrigger = false; // show red "TR" top left
     } else {                        // Not triggered and not NORMAL mode
         // Use the free running trace, discard history
         triggeredResult.data.clear();          // discard trace
+        triggeredResult.statistics.clear();
         triggeredResult.triggeredPosition = 0; // not triggered
+        triggeredResult.triggerEvents.clear();
+        resultHoldsTriggered = false;
         result.liveTrigger = false;            // show red "TR" top left
     }
     return result.liveTrigger;
 } // bool Triggering::provideTriggeredData()
+
+
+void Triggering::reclaimTriggeredData( DSOsamples &result ) {
+    if ( !resultHoldsTriggered )
+        return;
+    // move the shown triggered trace back into the storage, the next block is converted into the spare buffers
+    swapBuffers( result );
+    resultHoldsTriggered = false;
+}
+
+
+void Triggering::swapBuffers( DSOsamples &result ) {
+    result.data.swap( triggeredResult.data );
+    result.statistics.swap( triggeredResult.statistics );
+    result.triggerEvents.swap( triggeredResult.triggerEvents );
+}
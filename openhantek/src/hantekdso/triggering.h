@@ -6,21 +6,34 @@
 #include "dsosamples.h"
 #include "errorcodes.h"
 #include "scopesettings.h"
+#include "triggerengine.h"
 
 class Triggering {
   public:
     explicit Triggering( const DsoSettingsScope *scope, const Dso::ControlSettings &controlsettings );
     int searchTriggeredPosition( DSOsamples &result );
+    /// \brief Quick check on the raw data of the trigger channel before the conversion, false: cannot trigger.
+    /// \param offset, scale The calibrated conversion of the trigger channel, voltage = ( code - offset ) * scale.
+    bool mayTrigger( const uint8_t *data, unsigned channels, unsigned count, double offset, double scale ) const;
     bool provideTriggeredData( DSOsamples &result );
+    /// \brief Call before a new block is converted into result (result locked).
+    /// A triggered trace that is still shown is moved back into the storage without copying the samples.
+    void reclaimTriggeredData( DSOsamples &result );
     int getTriggeredPositionRaw() { return triggeredPositionRaw; }
     void resetTriggeredPositionRaw() { triggeredPositionRaw = 0; }
 
   private:
+    static const size_t MULTI_TRIGGER_MAX = 100; // multi trigger: max. number of traces per block
     const DsoSettingsScope *scope;
     const Dso::ControlSettings &controlsettings;
-    int searchTriggerPoint( DSOsamples &result, Dso::Slope dsoSlope, int startPos = 0 );
     Dso::Slope mirrorSlope( Dso::Slope slope ) {
         return ( slope == Dso::Slope::Positive ? Dso::Slope::Negative : Dso::Slope::Positive );
     }
-    int triggeredPositionRaw = 0; // not triggered
+    void swapBuffers( DSOsamples &result );
+    int triggeredPositionRaw = 0;                // not triggered
+    Dso::Slope nextSlope = Dso::Slope::Positive; // for alternating slope mode X
+    DSOsamples triggeredResult;                  // storage for last triggered trace samples or spare buffers
+    bool resultHoldsTriggered = false;           // the last triggered trace is in result, the spare buffers in storage
+    std::vector< double > prefixSum;             // prefixSum[ i ] = sum of samples [0, i) of the trigger channel
+    std::vector< TriggerEngine::Result > events; // multi trigger: all events of the block
 };
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "workerpool.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QWaitCondition>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+
+namespace {
+
+// State of one run() call, shared with the runnables, a runnable that starts after the job is finished
+// finds no free task and does not access the task function
+struct Job {
+    Job( unsigned count, const std::function< void( unsigned ) > *task ) : count( count ), task( task ) {}
+
+    void work() {
+        unsigned worked = 0;
+        for ( unsigned index = next.fetch_add( 1 ); index < count; index = next.fetch_add( 1 ) ) {
+            ( *task )( index );
+            ++worked;
+        }
+        if ( worked ) {
+            QMutexLocker locker( &mutex );
+            done += worked;
+            if ( done == count )
+                finished.wakeAll();
+        }
+    }
+
+    const unsigned count;
+    const std::function< void( unsigned ) > *task;
+    std::atomic< unsigned > next{ 0 };
+    QMutex mutex;
+    QWaitCondition finished;
+    unsigned done = 0;
+};
+
+
+class JobRunner : public QRunnable {
+  public:
+    explicit JobRunner( const std::shared_ptr< Job > &job ) : job( job ) {}
+    void run() override { job->work(); }
+
+  private:
+    std::shared_ptr< Job > job;
+};
+
+} // namespace
+
+
+WorkerPool::WorkerPool( int maxThreads ) {
+    pool.setMaxThreadCount( std::max( maxThreads, 0 ) );
+    pool.setExpiryTimeout( -1 ); // keep the threads, a job is started for every frame
+}
+
+
+WorkerPool::~WorkerPool() { pool.waitForDone(); }
+
+
+void WorkerPool::run( unsigned count, const std::function< void( unsigned ) > &task ) {
+    const unsigned workers = std::min( count ? count - 1 : 0, unsigned( pool.maxThreadCount() ) );
+    if ( !workers ) { // nothing to share
+        for ( unsigned index = 0; index < count; ++index )
+            task( index );
+        return;
+    }
+    std::shared_ptr< Job > job = std::make_shared< Job >( count, &task );
+    for ( unsigned worker = 0; worker < workers; ++worker )
+        pool.start( new JobRunner( job ) ); // auto deleted by the pool
+    job->work();
+    QMutexLocker locker( &job->mutex );
+    while ( job->done < count )
+        job->finished.wait( &job->mutex );
+}
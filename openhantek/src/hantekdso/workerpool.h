@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <QThreadPool>
+#include <functional>
+
+
+/// \brief Fork / join helper for the data conversion on a small pool of worker threads.
+///
+/// run() splits a job into count independent tasks, the workers and the calling thread take the next free task
+/// from a shared counter until all are done, i.e. a worker that is late or busy elsewhere does not delay the job.
+/// run() returns after all tasks are finished, the task function may use references to the caller's stack.
+class WorkerPool {
+  public:
+    /// \param maxThreads The number of worker threads, the calling thread is not counted.
+    explicit WorkerPool( int maxThreads = QThread::idealThreadCount() - 1 );
+    ~WorkerPool();
+
+    /// \brief Call task( index ) for each index in [0, count) and wait until all calls are finished.
+    void run( unsigned count, const std::function< void( unsigned ) > &task );
+
+    /// \brief The number of threads that work on a job, including the calling thread.
+    int threadCount() const { return pool.maxThreadCount() + 1; }
+
+  private:
+    QThreadPool pool;
+};
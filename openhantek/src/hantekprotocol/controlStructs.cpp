@@ -37,10 +37,16 @@ ControlSetNumChannels::ControlSetNumChannels() : ControlCommand( ControlCode::CO
 void ControlSetNumChannels::setNumChannels( uint8_t val ) { data()[ 0 ] = val; }
 
 
-ControlStartSampling::ControlStartSampling() : ControlCommand( ControlCode::CONTROL_STARTSAMPLING, 1 ) { data()[ 0 ] = 0x01; }
+ControlStartSampling::ControlStartSampling() : ControlCommand( ControlCode::CONTROL_STARTSAMPLING, 1 ) {
+    setting = false;
+    data()[ 0 ] = 0x01;
+}
 
 
-ControlStopSampling::ControlStopSampling() : ControlCommand( ControlCode::CONTROL_STARTSAMPLING, 1 ) { data()[ 0 ] = 0x00; }
+ControlStopSampling::ControlStopSampling() : ControlCommand( ControlCode::CONTROL_STARTSAMPLING, 1 ) {
+    setting = false;
+    data()[ 0 ] = 0x00;
+}
 
 
 ControlGetCalibration::ControlGetCalibration() : ControlCommand( ControlCode::CONTROL_EEPROM, sizeof( CalibrationValues ) ) {
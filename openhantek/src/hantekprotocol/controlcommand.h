@@ -16,7 +16,22 @@ class ControlCommand : public std::vector< uint8_t > {
 
   public:
     bool pending = false;
+    bool setting = true; // the device keeps the payload, false for actions that must be sent always (e.g. start sampling)
     uint8_t code;
     uint8_t value = 0;
     ControlCommand *next = nullptr;
+
+    /// \brief The payload differs from the last one sent to the device (or nothing was sent yet).
+    bool isChanged() const { return !setting || !sentValid || sent != *this; }
+    /// \brief Remember the payload that the device has now.
+    void markSent() {
+        sent = *this;
+        sentValid = true;
+    }
+    /// \brief Forget the last sent payload, e.g. after a device reset, the next command will be sent always.
+    void invalidateSent() { sentValid = false; }
+
+  private:
+    std::vector< uint8_t > sent; // last payload sent to the device
+    bool sentValid = false;
 };
@@ -4,3 +4,12 @@
 
 typedef unsigned RecordLengthID;
 typedef unsigned ChannelID;
+
+/// The storage type of the converted samples (DSOsamples, SampleValues), float halves the memory footprint
+/// of all processing stages, the reductions (sums, rms, spectrum) are calculated in double.
+/// Build with "cmake -DOPENHANTEK_DOUBLE_SAMPLES=ON" to store double precision samples.
+#ifdef OPENHANTEK_DOUBLE_SAMPLES
+typedef double Sample;
+#else
+typedef float Sample;
+#endif
@@ -35,6 +35,7 @@
 #include "capturing.h"
 #include "dsomodel.h"
 #include "hantekdsocontrol.h"
+#include "rawplayer.h"
 #include "usb/scopedevice.h"
 
 // Post processing
@@ -94,6 +95,7 @@ int main( int argc, char *argv[] ) {
 
     bool demoMode = false;
     bool autoConnect = true;
+    bool streaming = false;
     bool useGLES = false;
     bool useGLSL120 = false;
     bool useGLSL150 = false;
@@ -106,6 +108,10 @@ int main( int argc, char *argv[] ) {
     int toolTipVisible = 1;           // start with tooltips
     bool styleFusion = false;         // use system style
     QString configFileName = QString();
+    QString recordFileName = QString();
+    QString playbackFileName = QString();
+    bool unthrottled = false;
+    QString demoSignal = QString();
 
     { // do this early at program start ...
         // get font size and other global program settings:
@@ -161,6 +167,23 @@ int main( int argc, char *argv[] ) {
         QCommandLineOption noAutoConnectOption( "noAutoConnect",
                                                 QCoreApplication::translate( "main", "Do not connect automatically" ) );
         p.addOption( noAutoConnectOption );
+        QCommandLineOption streamingOption(
+            "streaming", QCoreApplication::translate( "main", "Continuous USB streaming for higher sample rates (experimental)" ) );
+        p.addOption( streamingOption );
+        QCommandLineOption recordOption( "record", QCoreApplication::translate( "main", "Record the raw samples into a file" ),
+                                         QCoreApplication::translate( "main", "File" ) );
+        p.addOption( recordOption );
+        QCommandLineOption playbackOption( "playback", QCoreApplication::translate( "main", "Replay a raw sample recording" ),
+                                           QCoreApplication::translate( "main", "File" ) );
+        p.addOption( playbackOption );
+        QCommandLineOption unthrottledOption(
+            "unthrottled", QCoreApplication::translate( "main", "Demo and playback as fast as possible, not in real time" ) );
+        p.addOption( unthrottledOption );
+        QCommandLineOption demoSignalOption(
+            "demoSignal",
+            QCoreApplication::translate( "main", "Demo signals, e.g. \"1 sine 1000 2;2 am 10000 1 0 0.5;glitch 100\"" ),
+            QCoreApplication::translate( "main", "Signals" ) );
+        p.addOption( demoSignalOption );
         p.addOption( useGlesOption );
         QCommandLineOption useGLSL120Option( "useGLSL120", QCoreApplication::translate( "main", "Force OpenGL SL version 1.20" ) );
         p.addOption( useGLSL120Option );
@@ -194,6 +217,14 @@ int main( int argc, char *argv[] ) {
             configFileName = p.value( "config" );
         demoMode = p.isSet( demoModeOption );
         autoConnect = !p.isSet( noAutoConnectOption );
+        streaming = p.isSet( streamingOption );
+        if ( p.isSet( recordOption ) )
+            recordFileName = p.value( "record" );
+        if ( p.isSet( playbackOption ) )
+            playbackFileName = p.value( "playback" );
+        unthrottled = p.isSet( unthrottledOption );
+        if ( p.isSet( demoSignalOption ) )
+            demoSignal = p.value( "demoSignal" );
         if ( p.isSet( fontOption ) )
             font = p.value( "font" );
         if ( p.isSet( sizeOption ) )
@@ -330,7 +361,14 @@ int main( int argc, char *argv[] ) {
 
     std::unique_ptr< ScopeDevice > scopeDevice = nullptr;
 
-    if ( !demoMode ) {
+    if ( !playbackFileName.isEmpty() ) { // replay a recording w/o hardware
+        std::unique_ptr< RawPlayer > player( new RawPlayer );
+        if ( !player->open( playbackFileName ) ) {
+            qCritical() << "Cannot replay" << playbackFileName << player->getErrorString();
+            return -1;
+        }
+        scopeDevice = std::unique_ptr< ScopeDevice >( new ScopeDevice( player.release() ) );
+    } else if ( !demoMode ) {
         if ( verboseLevel )
             qDebug() << startupTime.elapsed() << "ms:"
                      << "init libusb";
@@ -363,10 +401,17 @@ int main( int argc, char *argv[] ) {
                     qCritical() << errorMessage;
                 return -1;
             }
+            // streaming only for models that define the sample rate limits of the continuous transfer
+            if ( streaming && scopeDevice->getModel()->spec()->samplerate.singleStreamingMax <= 0 ) {
+                qWarning() << "Continuous USB streaming is not supported by" << scopeDevice->getModel()->name;
+                streaming = false;
+            }
+            scopeDevice->setStreamingMode( streaming );
         }
     } else {
         scopeDevice = std::unique_ptr< ScopeDevice >( new ScopeDevice() );
     }
+    scopeDevice->setUnthrottled( unthrottled );
 
     // Here we have either a connected scope device or a demo device w/o hardware
     const DSOModel *model = scopeDevice->getModel();
@@ -511,9 +556,20 @@ int main( int argc, char *argv[] ) {
         qDebug() << startupTime.elapsed() << "ms:"
                  << "start DSO control thread";
     dsoControl.enableSamplingUI();
+#if ( QT_VERSION >= QT_VERSION_CHECK( 5, 15, 0 ) )
+    for ( const QString &command : demoSignal.split( ';', Qt::SkipEmptyParts ) ) // configure the demo signals
+#else
+    for ( const QString &command : demoSignal.split( ';', QString::SkipEmptyParts ) ) // configure the demo signals
+#endif
+        if ( dsoControl.stringCommand( "demo " + command ) != Dso::ErrorCode::NONE )
+            qWarning() << "Invalid demo signal" << command;
+    if ( !recordFileName.isEmpty() ) // start recording with the 1st captured block
+        dsoControl.startRecording( recordFileName );
     postProcessingThread.start();
     dsoControlThread.start();
     CapturingThread capturingThread( &dsoControl ); // low level capture in separate thread
+    QElapsedTimer captureTime;                      // playback throughput
+    captureTime.start();
     capturingThread.start();
 
     if ( verboseLevel )
@@ -541,6 +597,19 @@ int main( int argc, char *argv[] ) {
     waitForDso = qMax( waitForDso, 10000U ); // wait for at least 10 s
     capturingThread.requestInterruption();
     capturingThread.wait( waitForDso );
+    dsoControl.stopRecording(); // truncate the last segment file
+    QString playbackStatistics;
+    if ( scopeDevice->isPlayback() ) { // show the throughput at the end
+        const RawPlayer *player = scopeDevice->getPlayer();
+        double seconds = captureTime.elapsed() / 1e3;
+        double megaBytes = player->getBytesPlayed() / 1e6;
+        playbackStatistics = QString( "Playback: %1 blocks, %2 MB in %3 s (%4 MB/s), %5 blocks not processed\n" )
+                                 .arg( player->getBlocksPlayed() )
+                                 .arg( megaBytes, 0, 'f', 1 )
+                                 .arg( seconds, 0, 'f', 1 )
+                                 .arg( megaBytes / seconds, 0, 'f', 1 )
+                                 .arg( dsoControl.getDroppedBlocks() );
+    }
     if ( verboseLevel < 2 )
         std::cerr << "has "; // 2nd part
 
@@ -570,6 +639,7 @@ int main( int argc, char *argv[] ) {
         std::cerr << "OpenHantek6022 has stopped after "; // part 1..4
 
     std::cerr << openHantekMainWindow.elapsedTime.elapsed() / 1000 << " s\n"; // last part
+    std::cerr << playbackStatistics.toStdString();
 
     return appStatus;
 }
@@ -25,6 +25,8 @@
 #include <QDesktopServices>
 #include <QDir>
 #include <QFileDialog>
+#include <QInputDialog>
+#include <QLabel>
 #include <QLoggingCategory>
 #include <QMessageBox>
 #include <QPainter>
@@ -136,7 +138,8 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
                         ? tr( "OpenHantek6022 (%1) - Device %2 (FW%3)" )
                               .arg( QString::fromStdString( VERSION ), dsoControl->getModel()->name )
                               .arg( dsoControl->getDevice()->getFwVersion(), 4, 16, QChar( '0' ) )
-                        : tr( "OpenHantek6022 (%1) - " ).arg( QString::fromStdString( VERSION ) ) + tr( "Demo Mode" ) );
+                        : tr( "OpenHantek6022 (%1) - " ).arg( QString::fromStdString( VERSION ) ) +
+                              ( dsoControl->getDevice()->isPlayback() ? tr( "Playback" ) : tr( "Demo Mode" ) ) );
 
 #if ( QT_VERSION >= QT_VERSION_CHECK( 5, 6, 0 ) )
     setDockOptions( dockOptions() | QMainWindow::GroupedDragging );
@@ -180,6 +183,32 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
 
     ui->menuExport->addSeparator();
 
+    action = new QAction( QIcon( iconPath + "exporter.svg" ), tr( "&Record Raw Samples .." ), this );
+    action->setToolTip( tr( "Record the unconverted 8 bit samples of every captured block into a file" ) );
+    action->setCheckable( true );
+    connect( action, &QAction::toggled, this, [ this, action, dsoControl ]( bool checked ) {
+        if ( !checked ) {
+            dsoControl->stopRecording();
+            return;
+        }
+        QString recordFileName =
+            QFileDialog::getSaveFileName( this, tr( "Record raw samples" ), "", tr( "Raw samples (*.ohraw)" ), nullptr,
+                                          QFileDialog::DontUseNativeDialog );
+        if ( !recordFileName.isEmpty() && !recordFileName.endsWith( ".ohraw" ) )
+            recordFileName.append( ".ohraw" );
+        if ( recordFileName.isEmpty() || !dsoControl->startRecording( recordFileName ) ) {
+            QSignalBlocker blocker( action );
+            action->setChecked( false );
+        }
+    } );
+    connect( dsoControl, &HantekDsoControl::recordingStopped, this, [ action ]() {
+        QSignalBlocker blocker( action ); // show the state, the recording is already stopped
+        action->setChecked( false );
+    } );
+    ui->menuExport->addAction( action );
+
+    ui->menuExport->addSeparator();
+
     for ( auto *exporter : *exporterRegistry ) {
         action = new QAction( QIcon( iconPath + "exporter.svg" ), exporter->name(), this );
         action->setToolTip( tr( "Export captured data in %1 format for further processing" ).arg( exporter->format() ) );
@@ -280,6 +309,75 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
         statusBar()->showMessage( text, timeout );
     } );
 
+    // USB transfer statistics inside the status bar, updated once per second
+    QLabel *statisticsLabel = new QLabel( this );
+    statisticsLabel->hide();
+    statusBar()->addPermanentWidget( statisticsLabel );
+    QTimer *statisticsTimer = new QTimer( this );
+    connect( statisticsTimer, &QTimer::timeout, this,
+             [ this, statisticsLabel, dsoControl ]() {
+                 TransferStatistics now = dsoControl->getDevice()->getTransferStatistics();
+                 TransferStatistics delta = now; // the values of the last interval
+                 delta.time -= lastStatistics.time;
+                 delta.transfers -= lastStatistics.transfers;
+                 delta.bytes -= lastStatistics.bytes;
+                 for ( unsigned bucket = 0; bucket < TransferStatistics::LATENCY_BUCKETS; ++bucket )
+                     delta.latencyHistogram[ bucket ] -= lastStatistics.latencyHistogram[ bucket ];
+                 delta.captureTime -= lastStatistics.captureTime;
+                 delta.deadTime -= lastStatistics.deadTime;
+                 lastStatistics = now;
+                 if ( delta.time <= 0 )
+                     return;
+                 statisticsLabel->setText( tr( "USB: %1 MB/s, latency 90%: %2 ms, max: %3 ms, retries: %4, timeouts: %5, "
+                                               "gap: %6 ms, capture: %7 %" )
+                                               .arg( 1e3 * double( delta.bytes ) / double( delta.time ), 0, 'f', 2 )
+                                               .arg( 1e-6 * double( delta.latencyPercentile( 0.9 ) ), 0, 'f', 1 )
+                                               .arg( 1e-6 * double( now.latencyMax ), 0, 'f', 1 )
+                                               .arg( now.retries )
+                                               .arg( now.timeouts )
+                                               .arg( 1e-6 * double( now.blockGap ), 0, 'f', 1 )
+                                               .arg( 100 * delta.captureRatio(), 0, 'f', 0 ) );
+             } );
+    QAction *statisticsAction = new QAction( tr( "Transfer Statistics" ), this );
+    statisticsAction->setToolTip( tr( "Show the USB transfer rate, latency and capture duty cycle in the status bar" ) );
+    statisticsAction->setCheckable( true );
+    connect( statisticsAction, &QAction::toggled, this, [ statisticsLabel, statisticsTimer ]( bool checked ) {
+        statisticsLabel->setVisible( checked );
+        if ( checked )
+            statisticsTimer->start( 1000 );
+        else
+            statisticsTimer->stop();
+    } );
+    ui->menuView->addSeparator();
+    ui->menuView->addAction( statisticsAction );
+
+    // Sequence mode: capture N blocks back-to-back, browse them afterwards
+    ui->menuOscilloscope->addSeparator();
+    QAction *sequenceAction = new QAction( tr( "Capture Se&quence .." ), this );
+    sequenceAction->setToolTip( tr( "Capture a number of blocks as fast as possible and browse them afterwards" ) );
+    connect( sequenceAction, &QAction::triggered, this, [ this, dsoControl ]() {
+        bool ok;
+        int count =
+            QInputDialog::getInt( this, tr( "Capture Sequence" ), tr( "Number of blocks" ), sequenceLength, 1, 10000, 1, &ok );
+        if ( !ok )
+            return;
+        sequenceLength = count;
+        QMetaObject::invokeMethod( dsoControl, "startSequence", Q_ARG( unsigned, unsigned( count ) ) );
+    } );
+    ui->menuOscilloscope->addAction( sequenceAction );
+    QAction *previousSegmentAction = new QAction( tr( "&Previous Segment" ), this );
+    previousSegmentAction->setShortcut( QKeySequence( Qt::Key::Key_PageUp ) );
+    connect( previousSegmentAction, &QAction::triggered, this, [ dsoControl ]() {
+        QMetaObject::invokeMethod( dsoControl, "showSegment", Q_ARG( int, int( dsoControl->getSegmentIndex() ) - 1 ) );
+    } );
+    ui->menuOscilloscope->addAction( previousSegmentAction );
+    QAction *nextSegmentAction = new QAction( tr( "&Next Segment" ), this );
+    nextSegmentAction->setShortcut( QKeySequence( Qt::Key::Key_PageDown ) );
+    connect( nextSegmentAction, &QAction::triggered, this, [ dsoControl ]() {
+        QMetaObject::invokeMethod( dsoControl, "showSegment", Q_ARG( int, int( dsoControl->getSegmentIndex() ) + 1 ) );
+    } );
+    ui->menuOscilloscope->addAction( nextSegmentAction );
+
     // Connect signals to DSO controller and widget
     connect( horizontalDock, &HorizontalDock::samplerateChanged, dsoControl,
              [ dsoControl, this ]() { dsoControl->setSamplerate( dsoSettings->scope.horizontal.samplerate ); } );
@@ -321,6 +419,13 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
     connect( triggerDock, &TriggerDock::sourceChanged, dsoWidget, &DsoWidget::updateTriggerSource );
     connect( triggerDock, &TriggerDock::smoothChanged, dsoControl, &HantekDsoControl::setTriggerSmooth );
     // should we send the smooth mode also to dsoWidget?
+    connect( triggerDock, &TriggerDock::typeChanged, dsoControl, &HantekDsoControl::setTriggerType );
+    connect( triggerDock, &TriggerDock::conditionChanged, dsoControl, &HantekDsoControl::setTriggerCondition );
+    connect( triggerDock, &TriggerDock::time1Changed, dsoControl, &HantekDsoControl::setTriggerTime1 );
+    connect( triggerDock, &TriggerDock::time2Changed, dsoControl, &HantekDsoControl::setTriggerTime2 );
+    connect( triggerDock, &TriggerDock::heightChanged, dsoControl, &HantekDsoControl::setTriggerHeight );
+    connect( triggerDock, &TriggerDock::hysteresisChanged, dsoControl, &HantekDsoControl::setTriggerHysteresis );
+    connect( triggerDock, &TriggerDock::multiTriggerChanged, dsoControl, &HantekDsoControl::setTriggerMulti );
     connect( triggerDock, &TriggerDock::slopeChanged, dsoControl, &HantekDsoControl::setTriggerSlope );
     connect( triggerDock, &TriggerDock::slopeChanged, dsoWidget, &DsoWidget::updateTriggerSlope );
     connect( dsoWidget, &DsoWidget::triggerPositionChanged, dsoControl, &HantekDsoControl::setTriggerPosition );
@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "scopesettings.h"
+#include "usb/transferstatistics.h"
 
 class SpectrumGenerator;
 class HantekDsoControl;
@@ -48,6 +49,8 @@ class MainWindow : public QMainWindow {
     QIcon iconPause;
     QIcon iconPlay;
     QLineEdit *commandEdit;
+    TransferStatistics lastStatistics; // previous snapshot for the status bar readout
+    int sequenceLength = 100;          // number of blocks of the last sequence capture
 
     // Central widgets
     DsoWidget *dsoWidget;
@@ -13,6 +13,9 @@
 #include "viewsettings.h"
 
 
+static const unsigned binsPerDiv = 50; // resolution of histogram
+
+
 static const SampleValues &useSpecSamplesOf( ChannelID channel, const PPresult *result, const DsoSettingsScope *scope ) {
     static SampleValues emptyDefault;
     if ( !scope->spectrum[ channel ].used || !result->data( channel ) )
@@ -67,101 +70,32 @@ void GraphGenerator::generateGraphsTYvoltage( PPresult *result ) {
         qDebug() << "     GraphGenerator::generateGraphsTYvoltage()" << result->tag;
     result->vaChannelVoltage.resize( scope->voltage.size() );
     result->vaChannelHistogram.resize( scope->voltage.size() );
-    bool interpolationStep = view->interpolation == Dso::INTERPOLATION_STEP;
-    bool interpolationSinc = view->interpolation == Dso::INTERPOLATION_SINC;
+    result->vaChannelSegments.resize( scope->voltage.size() );
+    result->segmentDots.resize( scope->voltage.size() );
     for ( ChannelID channel = 0; channel < scope->voltage.size(); ++channel ) {
         ChannelGraph &graphVoltage = result->vaChannelVoltage[ channel ];
         ChannelGraph &graphHistogram = result->vaChannelHistogram[ channel ];
+        ChannelGraph &graphSegments = result->vaChannelSegments[ channel ];
+        std::vector< unsigned > &segmentDots = result->segmentDots[ channel ];
         const SampleValues &sampleValues = useVoltSamplesOf( channel, result, scope );
+        graphVoltage.clear();   // remove all previous dots and fill in new trace as GL_LINE_STRIP
+        graphHistogram.clear(); // remove all previous line and fill in new histo as GL_LINES
+        graphSegments.clear();
+        segmentDots.clear();
 
         // Check if this channel is used and available at the data analyzer
-        if ( sampleValues.samples.empty() ) {
-            // Delete all vector arrays
-            graphVoltage.clear();
-            graphHistogram.clear();
+        if ( sampleValues.samples.empty() )
             continue;
-        }
-
-        // time distance between sampling points
-        double horizontalFactor = ( sampleValues.interval / scope->horizontal.timebase );
-        // printf( "hF: %g\n", horizontalFactor );
-        unsigned dotsOnScreen = unsigned( ceil( DIVS_TIME / horizontalFactor ) );
-        unsigned preTrigSamples = unsigned( scope->trigger.position * dotsOnScreen );
-        // align displayed trace with trigger mark on screen ...
-        // ... also if trig pos or time/div was changed on a "frozen" or single trace
-        int leftmostSample = int( result->triggeredPosition );
-        if ( leftmostSample )                     // adjust position if triggered, else start from sample[0]
-            leftmostSample -= preTrigSamples + 1; // shift samples to show a stable trace
-        int leftmostPosition = 0;                 // start position on display
-        if ( leftmostSample < 0 ) {               // trig pos or time/div was increased
-            leftmostPosition = -leftmostSample;   // trace can't start on left margin
-            leftmostSample = 0;                   // show as much as we have on left side
-        }
-
-        const unsigned binsPerDiv = 50; // resolution of histogram
-
-        // Set size directly to avoid reallocations (n+1 dots to display n lines)
-        graphVoltage.reserve( ++dotsOnScreen * ( interpolationStep ? 2 : 1 ) ); // two dots per "Step"
-        graphHistogram.reserve( int( 2 * ( binsPerDiv * DIVS_VOLTAGE ) ) );
-
-        const double gain = scope->gain( channel );
-        const double offset = scope->voltage[ channel ].offset;
-
-        auto sampleIterator = sampleValues.samples.cbegin() + leftmostSample; // -> visible samples
-        auto sampleEnd = sampleValues.samples.cend();
-
-        // sinc interpolation if there are too less samples on screen
-        // https://ccrma.stanford.edu/~jos/resample/resample.pdf
-        if ( interpolationSinc && dotsOnScreen < view->screenWidth ) {
-            // we would need sincWidth, but we take what we get
-            const unsigned int left = std::min( sincWidth, unsigned( leftmostSample ) );
-            horizontalFactor /= oversample;                                     // distance between (resampled) dots
-            dotsOnScreen = unsigned( DIVS_TIME / horizontalFactor + 0.99 + 1 ); // dot count after resample
-            const unsigned int resampleSize = ( left + dotsOnScreen + sincWidth ) * oversample;
-            resample.clear();                // invalidate old content
-            resample.resize( resampleSize ); //  ... and init with zero because we accumulate the convolution
-            auto sampleIt = sampleValues.samples.cbegin() + leftmostSample;
-            for ( unsigned int resamplePos = 0; resamplePos < resampleSize; resamplePos += oversample ) {
-                resample[ resamplePos ] += *sampleIt; // sinc( 0 ) sum up, do NOT assign
-                auto sincIt = sinc.cbegin();          // -> one half of sinc pulse without sinc(0)
-                for ( unsigned int sincPos = 1; sincPos <= sincSize; ++sincPos ) {
-                    const double convolute = *sampleIt * *sincIt;
-                    if ( resamplePos >= sincPos ) // left half of sinc in visible range
-                        resample[ resamplePos - sincPos ] += convolute;
-                    if ( resamplePos + sincPos < resampleSize ) // right half of sinc visible
-                        resample[ resamplePos + sincPos ] += convolute;
-                    ++sincIt;
-                }
-                ++sampleIt;
-            }
-            leftmostPosition *= oversample;            // scale the position accordingly
-            graphVoltage.reserve( resampleSize );      // provide enough space for resampled dots
-            sampleIterator = resample.cbegin() + left; // now switch from samples -> resamples
-            sampleEnd = resample.cend();               // ... same for end of samples
-        }
 
-        graphVoltage.clear();   // remove all previous dots and fill in new trace as GL_LINE_STRIP
-        graphHistogram.clear(); // remove all previous line and fill in new histo as GL_LINES
         unsigned bins[ int( binsPerDiv * DIVS_VOLTAGE ) ] = { 0 };
-        for ( unsigned int position = unsigned( leftmostPosition ); position < dotsOnScreen && sampleIterator < sampleEnd - 1;
-              ++position ) {
-            double x = double( MARGIN_LEFT + position * horizontalFactor );
-            double y_1 = *sampleIterator++ / gain + offset;
-            double y = *sampleIterator / gain + offset;
-            if ( !scope->histogram ) { // show complete trace
-                if ( interpolationStep )
-                    graphVoltage.push_back( QVector3D( float( x ), float( y_1 ), 0.0f ) ); // insert horizontal step
-                graphVoltage.push_back( QVector3D( float( x ), float( y ), 0.0f ) );
-            } else { // histogram replaces trace in rightmost div
-                int bin = int( round( binsPerDiv * ( y + DIVS_VOLTAGE / 2 ) ) );
-                if ( bin > 0 && bin < binsPerDiv * DIVS_VOLTAGE ) // count value if trace is on screen
-                    ++bins[ bin ];
-                if ( x < MARGIN_RIGHT - 1.1 ) { // show trace unless in last div + 10% margin
-                    if ( interpolationStep )
-                        graphVoltage.push_back( QVector3D( float( x ), float( y_1 ), 0.0f ) ); // horizontal step
-                    graphVoltage.push_back( QVector3D( float( x ), float( y ), 0.0f ) );
-                }
-            }
+        appendTraceTY( channel, sampleValues, result->triggeredPosition, result->triggerOffset, graphVoltage, bins );
+        // multi trigger: the further events of the block, the 1st event is the triggered position
+        for ( size_t index = 1; index < result->triggerEvents.size(); ++index ) {
+            const double event = result->triggerEvents[ index ];
+            const int position = int( floor( event ) ) + 1; // 1st sample after the event, offset in (0, 1]
+            const size_t before = graphSegments.size();
+            appendTraceTY( channel, sampleValues, position, position - event, graphSegments, bins );
+            segmentDots.push_back( unsigned( graphSegments.size() - before ) );
         }
 
         if ( ( scope->horizontal.format == Dso::GraphFormat::TY ) && scope->histogram ) { // scale and display the histogram
@@ -184,6 +118,99 @@ void GraphGenerator::generateGraphsTYvoltage( PPresult *result ) {
 }
 
 
+void GraphGenerator::appendTraceTY( ChannelID channel, const SampleValues &sampleValues, int triggeredPosition,
+                                    double triggerOffset, ChannelGraph &graphVoltage, unsigned bins[] ) {
+    bool interpolationStep = view->interpolation == Dso::INTERPOLATION_STEP;
+    bool interpolationSinc = view->interpolation == Dso::INTERPOLATION_SINC;
+
+    // time distance between sampling points
+    double horizontalFactor = ( sampleValues.interval / scope->horizontal.timebase );
+    // printf( "hF: %g\n", horizontalFactor );
+    unsigned dotsOnScreen = unsigned( ceil( DIVS_TIME / horizontalFactor ) );
+    unsigned preTrigSamples = unsigned( scope->trigger.position * dotsOnScreen );
+    // align displayed trace with trigger mark on screen ...
+    // ... also if trig pos or time/div was changed on a "frozen" or single trace
+    // the interpolated trigger crossing is put exactly on the trigger mark with a sub-sample shift to the left,
+    // one more sample on the left side is shifted out of the screen, one more sample fills the right side
+    int leftmostSample = triggeredPosition;
+    double shift = 0.0;                       // sub-sample shift of the trace
+    if ( leftmostSample ) {                   // adjust position if triggered, else start from sample[0]
+        leftmostSample -= preTrigSamples + 2; // shift samples to show a stable trace
+        shift = ( triggerOffset - 1 ) * horizontalFactor;
+        ++dotsOnScreen;
+    }
+    int leftmostPosition = 0;               // start position on display
+    if ( leftmostSample < 0 ) {             // trig pos or time/div was increased
+        leftmostPosition = -leftmostSample; // trace can't start on left margin
+        leftmostSample = 0;                 // show as much as we have on left side
+    }
+
+    // Set size directly to avoid reallocations (n+1 dots to display n lines)
+    graphVoltage.reserve( graphVoltage.size() + ++dotsOnScreen * ( interpolationStep ? 2 : 1 ) ); // two dots per "Step"
+
+    const double gain = scope->gain( channel );
+    const double offset = scope->voltage[ channel ].offset;
+
+    auto sampleIterator = sampleValues.samples.cbegin() + leftmostSample; // -> visible samples
+    auto sampleEnd = sampleValues.samples.cend();
+
+    // sinc interpolation if there are too less samples on screen
+    // https://ccrma.stanford.edu/~jos/resample/resample.pdf
+    if ( interpolationSinc && dotsOnScreen < view->screenWidth ) {
+        // we would need sincWidth, but we take what we get
+        const unsigned int left = std::min( sincWidth, unsigned( leftmostSample ) );
+        horizontalFactor /= oversample;                                     // distance between (resampled) dots
+        dotsOnScreen = unsigned( DIVS_TIME / horizontalFactor + 0.99 + 1 ); // dot count after resample
+        auto sampleIt = sampleValues.samples.cbegin() + leftmostSample;
+        // input samples for the visible dots plus the sinc tails, but not beyond the end of the samples
+        // (a trigger event near the end of the block shows a shorter trace)
+        const unsigned int inputSize =
+            std::min( left + ( dotsOnScreen + oversample - 1 ) / oversample + sincWidth, unsigned( sampleEnd - sampleIt ) );
+        const unsigned int resampleSize = inputSize * oversample;
+        resample.clear();                // invalidate old content
+        resample.resize( resampleSize ); //  ... and init with zero because we accumulate the convolution
+        for ( unsigned int resamplePos = 0; resamplePos < resampleSize; resamplePos += oversample ) {
+            resample[ resamplePos ] += *sampleIt; // sinc( 0 ) sum up, do NOT assign
+            auto sincIt = sinc.cbegin();          // -> one half of sinc pulse without sinc(0)
+            for ( unsigned int sincPos = 1; sincPos <= sincSize; ++sincPos ) {
+                const Sample convolute = Sample( *sampleIt * *sincIt );
+                if ( resamplePos >= sincPos ) // left half of sinc in visible range
+                    resample[ resamplePos - sincPos ] += convolute;
+                if ( resamplePos + sincPos < resampleSize ) // right half of sinc visible
+                    resample[ resamplePos + sincPos ] += convolute;
+                ++sincIt;
+            }
+            ++sampleIt;
+        }
+        leftmostPosition *= oversample;                             // scale the position accordingly
+        graphVoltage.reserve( graphVoltage.size() + resampleSize ); // provide enough space for resampled dots
+        sampleIterator = resample.cbegin() + left;                  // now switch from samples -> resamples
+        sampleEnd = resample.cend();                                // ... same for end of samples
+    }
+
+    for ( unsigned int position = unsigned( leftmostPosition ); position < dotsOnScreen && sampleIterator < sampleEnd - 1;
+          ++position ) {
+        double x = double( MARGIN_LEFT + position * horizontalFactor + shift );
+        double y_1 = *sampleIterator++ / gain + offset;
+        double y = *sampleIterator / gain + offset;
+        if ( !scope->histogram ) { // show complete trace
+            if ( interpolationStep )
+                graphVoltage.push_back( QVector3D( float( x ), float( y_1 ), 0.0f ) ); // insert horizontal step
+            graphVoltage.push_back( QVector3D( float( x ), float( y ), 0.0f ) );
+        } else { // histogram replaces trace in rightmost div
+            int bin = int( round( binsPerDiv * ( y + DIVS_VOLTAGE / 2 ) ) );
+            if ( bin > 0 && bin < binsPerDiv * DIVS_VOLTAGE ) // count value if trace is on screen
+                ++bins[ bin ];
+            if ( x < MARGIN_RIGHT - 1.1 ) { // show trace unless in last div + 10% margin
+                if ( interpolationStep )
+                    graphVoltage.push_back( QVector3D( float( x ), float( y_1 ), 0.0f ) ); // horizontal step
+                graphVoltage.push_back( QVector3D( float( x ), float( y ), 0.0f ) );
+            }
+        }
+    }
+}
+
+
 void GraphGenerator::generateGraphsTYspectrum( PPresult *result ) {
     if ( scope->verboseLevel > 5 )
         qDebug() << "     GraphGenerator::generateGraphsTYspectrum()" << result->tag;
@@ -210,7 +237,7 @@ void GraphGenerator::generateGraphsTYspectrum( PPresult *result ) {
         double horizontalFactor = sampleValues.interval / scope->horizontal.frequencybase;
 
         // Fill vector array
-        std::vector< double >::const_iterator dataIterator = sampleValues.samples.begin();
+        std::vector< Sample >::const_iterator dataIterator = sampleValues.samples.begin();
         const double magnitude = scope->spectrum[ channel ].magnitude;
         const double offset = scope->spectrum[ channel ].offset;
 
@@ -258,8 +285,8 @@ void GraphGenerator::generateGraphsXY( PPresult *result ) {
         graphXY.reserve( sampleCount * 2 );
 
         // Fill vector array
-        std::vector< double >::const_iterator xIterator = xSamples.samples.begin();
-        std::vector< double >::const_iterator yIterator = ySamples.samples.begin();
+        std::vector< Sample >::const_iterator xIterator = xSamples.samples.begin();
+        std::vector< Sample >::const_iterator yIterator = ySamples.samples.begin();
         const double xGain = scope->gain( xChannel );
         const double yGain = scope->gain( yChannel );
         const double xOffset = ( scope->trigger.position - 0.5 ) * DIVS_TIME;
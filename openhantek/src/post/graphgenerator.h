@@ -9,11 +9,11 @@
 
 #include "hantekdso/enums.h"
 #include "hantekprotocol/types.h"
+#include "ppresult.h"
 #include "processor.h"
 
 struct DsoSettingsScope;
 struct DsoSettingsView;
-class PPresult;
 namespace Dso {
 struct ControlSpecification;
 }
@@ -27,6 +27,9 @@ class GraphGenerator : public QObject, public Processor {
 
   private:
     void generateGraphsTYvoltage( PPresult *result );
+    /// \brief Append the trace of one channel aligned to a trigger event, count the values for the histogram
+    void appendTraceTY( ChannelID channel, const SampleValues &sampleValues, int triggeredPosition, double triggerOffset,
+                        ChannelGraph &graphVoltage, unsigned bins[] );
     void generateGraphsTYspectrum( PPresult *result );
     void generateGraphsXY( PPresult *result );
 
@@ -39,7 +42,7 @@ class GraphGenerator : public QObject, public Processor {
     const unsigned int sincWidth = 2;                     // two periods
     const unsigned int oversample = 5;                    // 5 time oversample
     const unsigned int sincSize = sincWidth * oversample; // size of the table
-    std::vector< double > resample;                       // destination for overampled data
+    std::vector< Sample > resample;                       // destination for overampled data
 
     // Processor interface
     void process( PPresult *data ) override;
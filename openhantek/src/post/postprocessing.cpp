@@ -18,17 +18,21 @@ void PostProcessing::convertData( const DSOsamples *source, PPresult *destinatio
     if ( source->triggeredPosition ) {
         destination->softwareTriggerTriggered = source->liveTrigger;
         destination->triggeredPosition = source->triggeredPosition;
+        destination->triggerOffset = source->triggerOffset;
+        destination->triggerEvents = source->triggerEvents;
         destination->pulseWidth1 = source->pulseWidth1;
         destination->pulseWidth2 = source->pulseWidth2;
     } else {
         destination->softwareTriggerTriggered = false;
         destination->triggeredPosition = 0;
+        destination->triggerOffset = 0;
+        destination->triggerEvents.clear();
         destination->pulseWidth1 = 0;
         destination->pulseWidth2 = 0;
     }
 
     for ( ChannelID channel = 0; channel < source->data.size(); ++channel ) {
-        const std::vector< double > &rawChannelData = source->data.at( channel );
+        const std::vector< Sample > &rawChannelData = source->data.at( channel );
 
         if ( rawChannelData.empty() ) {
             continue;
@@ -36,11 +40,18 @@ void PostProcessing::convertData( const DSOsamples *source, PPresult *destinatio
         DataChannel *const channelData = destination->modifiableData( channel );
         channelData->voltage.interval = 1.0 / source->samplerate;
         channelData->voltage.samples = rawChannelData;
+        // use the statistics of the conversion if they match the samples, else calculate them now
+        if ( channel < source->statistics.size() && source->statistics[ channel ].isValidFor( rawChannelData ) )
+            channelData->statistics = source->statistics[ channel ];
+        else
+            channelData->statistics.calculate( rawChannelData );
         // printf( "PP CH%d: %d\n", channel+1, source->clipped );
         channelData->valid = !( source->clipped & ( 0x01 << channel ) );
     }
     destination->modifiableData( 2 )->voltageUnit = source->mathVoltageUnit; // MATH channel unit
     destination->tag = source->tag;
+    destination->timeStart = source->timeStart;
+    destination->timeEnd = source->timeEnd;
 }
 
 
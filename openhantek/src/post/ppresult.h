@@ -5,13 +5,14 @@
 #include <QReadWriteLock>
 #include <QVector3D>
 
+#include "hantekdso/samplestatistics.h"
 #include "hantekprotocol/types.h"
 #include "utils/printutils.h"
 #include <vector>
 
 /// \brief Struct for a array of sample values.
 struct SampleValues {
-    std::vector< double > samples; ///< Vector holding the sampling data
+    std::vector< Sample > samples; ///< Vector holding the sampling data
     double interval = 0.0;         ///< The interval between two sample values
 };
 
@@ -19,6 +20,7 @@ struct SampleValues {
 struct DataChannel {
     SampleValues voltage;          ///< The time-domain voltage levels (V)
     SampleValues spectrum;         ///< The frequency-domain power levels (dB)
+    SampleStatistics statistics;   ///< Min, max, sum etc. of the voltage samples
     bool valid = true;             ///< Not clipped, distorted, dropouts etc.
     double vmin = 0.0;             ///< The minimum sample value of _displayed_ part of trace
     double vmax = 0.0;             ///< The maximum sample value of _displayed_ part of trace
@@ -57,14 +59,20 @@ class PPresult {
     /// sw trigger status
     bool softwareTriggerTriggered = false;
     /// skip samples at start of channel to get triggered trace on screen
-    int triggeredPosition = 0; ///< Not triggered
-    double pulseWidth1 = 0.0;  ///< The width of the triggered pulse
-    double pulseWidth2 = 0.0;  ///< The width of the following pulse
-    unsigned tag;              ///< track individual sample blocks (debug support)
+    int triggeredPosition = 0;           ///< Not triggered
+    double triggerOffset = 0;            ///< The exact trigger crossing is at triggeredPosition - triggerOffset
+    std::vector< double > triggerEvents; ///< Multi trigger: exact sample times of all trigger events
+    double pulseWidth1 = 0.0;            ///< The width of the triggered pulse
+    double pulseWidth2 = 0.0;            ///< The width of the following pulse
+    unsigned tag;                        ///< track individual sample blocks (debug support)
+    int64_t timeStart = 0;               ///< steady clock time of the block's transfer start in ns
+    int64_t timeEnd = 0;                 ///< steady clock time of the block's transfer end in ns
 
     ChannelsGraphs vaChannelSpectrum;
     ChannelsGraphs vaChannelVoltage;
     ChannelsGraphs vaChannelHistogram;
+    ChannelsGraphs vaChannelSegments;                   ///< Multi trigger: the traces of the further events, one after the other
+    std::vector< std::vector< unsigned > > segmentDots; ///< Multi trigger: number of dots of each further trace
 
   private:
     std::vector< DataChannel > analyzedData; ///< The analyzed data for each channel
@@ -212,8 +212,7 @@ void SpectrumGenerator::process( PPresult *result ) {
         channelData->spectrum.samples.resize( size_t( sampleCount ) );
 
         // calculate the peak-to-peak value of the displayed part of trace
-        double min = INT_MAX;
-        double max = INT_MIN;
+        const SampleStatistics &statistics = channelData->statistics;
         double horizontalFactor = result->data( channel )->voltage.interval / scope->horizontal.timebase;
         unsigned dotsOnScreen = unsigned( DIVS_TIME / horizontalFactor + 0.99 ); // round up
         unsigned preTrigSamples = unsigned( scope->trigger.position * dotsOnScreen );
@@ -224,36 +223,22 @@ void SpectrumGenerator::process( PPresult *result ) {
         // unsigned right = result->triggerPosition + DIVS_TIME * scope->horizontal.timebase / channelData->voltage.interval;
         if ( right >= sampleCount )
             right = sampleCount - 1;
-        for ( int position = left; // left side of trace
-              position <= right;   // right side
-              ++position ) {
-            if ( channelData->voltage.samples[ unsigned( position ) ] < min )
-                min = channelData->voltage.samples[ unsigned( position ) ];
-            if ( channelData->voltage.samples[ unsigned( position ) ] > max )
-                max = channelData->voltage.samples[ unsigned( position ) ];
-        }
-        channelData->vmin = min;
-        channelData->vmax = max;
+        // min / max of the complete blocks are known from the conversion, only the window edges are scanned
+        statistics.windowMinMax( channelData->voltage.samples, size_t( left ), size_t( right ), channelData->vmin,
+                                 channelData->vmax );
         // channelData->vpp = max - min;
 
-        // calculate the average value
-        double dc = 0.0;
-        for ( auto &oneSample : channelData->voltage.samples )
-            dc += oneSample;
-        dc /= double( sampleCount );
+        // the average value
+        double dc = statistics.average();
         channelData->dc = dc;
 
-        // now strip DC bias, calculate rms of AC component and apply window for fft to AC component
-        double ac2 = 0.0;
+        // now strip DC bias and apply window for fft to AC component
         auto voltageIterator = channelData->voltage.samples.begin();
         auto windowIterator = window.begin();
         double *pfftW = fftWindowedValues;
-        for ( int position = 0; position < sampleCount; ++position ) {
-            double ac_sample = *voltageIterator++ - dc;
-            ac2 += ac_sample * ac_sample;
-            *pfftW++ = *windowIterator++ * ac_sample;
-        }
-        ac2 /= double( sampleCount );             // AC²
+        for ( int position = 0; position < sampleCount; ++position )
+            *pfftW++ = *windowIterator++ * ( *voltageIterator++ - dc );
+        double ac2 = statistics.acSquare();       // AC² = mean( x² ) - mean( x )²
         channelData->ac = sqrt( ac2 );            // rms of AC component
         channelData->rms = sqrt( dc * dc + ac2 ); // total rms = U eff
         channelData->dB = 20.0 * log10( channelData->rms ) - scope->analysis.spectrumReference;
@@ -368,8 +353,8 @@ void SpectrumGenerator::process( PPresult *result ) {
         double peakSpectrum = offsetLimit;            // get a start value for peak search
         int peakFreqPos = 0;                          // initial position of max spectrum peak
         position = 0;
-        min = INT_MAX;
-        max = INT_MIN;
+        double min = INT_MAX;
+        double max = INT_MIN;
         for ( auto &oneSample : channelData->spectrum.samples ) {
             // spectrum is power spectrum, but show amplitude spectrum -> 10 * log...
             double value = 10 * log10( oneSample ) + offset;
@@ -42,11 +42,18 @@ struct DsoSettingsScopeHorizontal {
 /// \brief Holds the settings for the trigger.
 /// TODO Use ControlSettingsTrigger
 struct DsoSettingsScopeTrigger {
-    Dso::TriggerMode mode = Dso::TriggerMode::AUTO; ///< Automatic, normal or single trigger
-    double position = 0.5;                          ///< Horizontal position for pretrigger (middle of screen)
-    Dso::Slope slope = Dso::Slope::Positive;        ///< Rising or falling edge causes trigger
-    int source = 0;                                 ///< Channel that is used as trigger source
-    int smooth = 0;                                 ///< Don't trigger on glitches
+    Dso::TriggerMode mode = Dso::TriggerMode::AUTO;                   ///< Automatic, normal or single trigger
+    double position = 0.5;                                            ///< Horizontal position for pretrigger (middle of screen)
+    Dso::Slope slope = Dso::Slope::Positive;                          ///< Rising or falling edge causes trigger
+    int source = 0;                                                   ///< Channel that is used as trigger source
+    int smooth = 0;                                                   ///< Don't trigger on glitches
+    Dso::TriggerType type = Dso::TriggerType::Edge;                   ///< The event that causes a trigger
+    Dso::TriggerCondition condition = Dso::TriggerCondition::Greater; ///< Time condition for pulse width and slew rate
+    double time1 = 1e-3;                                              ///< Pulse width, slew rate or timeout time (s)
+    double time2 = 2e-3;                                              ///< Upper time limit of the condition "within" (s)
+    double height = 0.5;                                              ///< Runt, window, slew rate: 2nd level = level + height (V)
+    double hysteresis = 0.0;                                          ///< Edge counts after passing level -/+ hysteresis (V)
+    bool multiTrigger = false;                                        ///< Show the traces of all trigger events of a block
 };
 
 /// \brief Base for DsoSettingsScopeSpectrum and DsoSettingsScopeVoltage
@@ -5,8 +5,10 @@
 #include <QDebug>
 #include <QDesktopServices>
 #include <QFileInfo>
+#include <QSocketNotifier>
 #include <QTimer>
 #include <QUrl>
+#include <vector>
 
 #include "devicelistentry.h"
 #include "deviceslistmodel.h"
@@ -107,6 +109,21 @@ std::unique_ptr< ScopeDevice > SelectSupportedDevice::showSelectDeviceModal( lib
 
     QTimer timer;
     timer.setInterval( 1000 );
+    // with hotplug support the device list is updated only after a bus change, polling is the fallback
+    std::vector< std::unique_ptr< QSocketNotifier > > usbNotifiers;
+    if ( findDevices->enableHotplug() ) {
+        if ( verboseLevel > 1 )
+            qDebug() << " SelectSupportedDevice::showSelectDeviceModal() USB hotplug enabled";
+        timer.setSingleShot( true );
+        timer.setInterval( 0 );
+        for ( int fd : findDevices->getPollFds() ) {
+            usbNotifiers.push_back( std::unique_ptr< QSocketNotifier >( new QSocketNotifier( fd, QSocketNotifier::Read ) ) );
+            // the int overload is available in all Qt5 versions
+            connect( usbNotifiers.back().get(), SIGNAL( activated( int ) ), this, SLOT( handleUsbEvents() ) );
+        }
+    }
+    deviceFinder = findDevices.get();
+    updateTimer = &timer;
     connect( &timer, &QTimer::timeout, this, [ this, &model, &findDevices, &messageDeviceReady, &messageNoDevices, autoConnect ]() {
         static int supportedDevices = -1; // max number of devices that can connect or need firmware
         static int readyDevices = -1;
@@ -154,6 +171,9 @@ std::unique_ptr< ScopeDevice > SelectSupportedDevice::showSelectDeviceModal( lib
     show();
     QCoreApplication::instance()->exec();
     timer.stop();
+    usbNotifiers.clear();
+    deviceFinder = nullptr;
+    updateTimer = nullptr;
     close();
     if ( demoModeClicked )
         return std::unique_ptr< ScopeDevice >( new ScopeDevice() );
@@ -161,6 +181,13 @@ std::unique_ptr< ScopeDevice > SelectSupportedDevice::showSelectDeviceModal( lib
 }
 
 
+// A libusb event file descriptor is readable, process the events and update the list after a hotplug event
+void SelectSupportedDevice::handleUsbEvents() {
+    if ( deviceFinder && deviceFinder->handleHotplugEvents() && updateTimer )
+        updateTimer->start();
+}
+
+
 void SelectSupportedDevice::showLibUSBFailedDialogModel( int error ) {
     ui->labelReadyState->setText( tr( "Can't initialize USB: %1" ).arg( libUsbErrorString( error ) ) );
     ui->buttonBox->button( QDialogButtonBox::Ok )->setEnabled( false );
@@ -6,10 +6,12 @@
 
 #include <QDialog>
 #include <QPushButton>
+#include <QTimer>
 
 #include "usb/scopedevice.h"
 #include <memory>
 
+class FindDevices;
 struct libusb_context;
 
 /**
@@ -28,6 +30,9 @@ class SelectSupportedDevice : public QDialog {
     std::unique_ptr< ScopeDevice > showSelectDeviceModal( libusb_context *context, int verboseLevel = 0, bool autoConnect = true );
     void showLibUSBFailedDialogModel( int error );
 
+  private slots:
+    void handleUsbEvents();
+
   private:
     void updateDeviceList();
     void updateSupportedDevices();
@@ -36,4 +41,6 @@ class SelectSupportedDevice : public QDialog {
     bool demoModeClicked = false;
     int verboseLevel = 0;
     QPushButton *btnDemoMode;
+    FindDevices *deviceFinder = nullptr; ///< Valid while showSelectDeviceModal() runs
+    QTimer *updateTimer = nullptr;       ///< Polls the device list or, with hotplug, runs once after a bus change
 };
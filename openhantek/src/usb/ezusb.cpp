@@ -672,3 +672,189 @@ exit:
     fclose( image );
     return ret;
 }
+
+/*****************************************************************************/
+
+#define FX_MEMORY_SIZE 0x10000 /* 64 KB address space of the 8051 */
+#define FX_WRITE_MAX 4096      /* max. size of one control transfer (e.g. WinUSB limit) */
+
+/*
+ * Return the value of the two hex digits at text or -1 if invalid.
+ */
+static int hex_byte( const char *text ) {
+    int value = 0;
+    for ( int iii = 0; iii < 2; ++iii ) {
+        char c = text[ iii ];
+        value <<= 4;
+        if ( c >= '0' && c <= '9' )
+            value |= c - '0';
+        else if ( c >= 'A' && c <= 'F' )
+            value |= c - 'A' + 10;
+        else if ( c >= 'a' && c <= 'f' )
+            value |= c - 'a' + 10;
+        else
+            return -1;
+    }
+    return value;
+}
+
+/*
+ * Parse an Intel HEX image held in memory into a memory image of the 8051,
+ * the bytes that are defined by the hex records are marked in "used".
+ * Returns the number of data bytes or a negative value on error.
+ */
+static int parse_ihex_buffer( const char *hex, size_t size, unsigned char *image, unsigned char *used ) {
+    const char *end = hex + size;
+    int total = 0;
+    for ( const char *line = hex; line < end; ) {
+        const char *eol = static_cast< const char * >( memchr( line, '\n', size_t( end - line ) ) );
+        if ( !eol )
+            eol = end;
+        size_t length = size_t( eol - line );
+        if ( length && line[ length - 1 ] == '\r' )
+            --length;
+        const char *record = line;
+        line = eol + 1;
+
+        /* EXTENSION: "# comment-till-end-of-line", for copyrights etc */
+        if ( length == 0 || record[ 0 ] == '#' )
+            continue;
+        if ( record[ 0 ] != ':' || length < 11 ) {
+            logerror( "not an ihex record: %.*s\n", int( length ), record );
+            return -2;
+        }
+
+        /* length, address, type, data and checksum are hex encoded bytes */
+        unsigned char bytes[ 5 + 255 ];
+        size_t count = ( length - 1 ) / 2;
+        if ( count > sizeof( bytes ) ) {
+            logerror( "record too long\n" );
+            return -4;
+        }
+        unsigned char sum = 0;
+        for ( size_t idx = 0; idx < count; ++idx ) {
+            int value = hex_byte( record + 1 + 2 * idx );
+            if ( value < 0 ) {
+                logerror( "invalid hex digit: %.*s\n", int( length ), record );
+                return -2;
+            }
+            bytes[ idx ] = uint8_t( value );
+            sum = uint8_t( sum + value );
+        }
+        const size_t len = bytes[ 0 ];
+        const uint32_t off = uint32_t( bytes[ 1 ] << 8 | bytes[ 2 ] );
+        const int type = bytes[ 3 ];
+        if ( count < len + 5 ) {
+            logerror( "record too short?\n" );
+            return -4;
+        }
+        if ( sum != 0 ) {
+            logerror( "checksum error: %.*s\n", int( length ), record );
+            return -5;
+        }
+
+        /* If this is an EOF record, then make it so. */
+        if ( type == 1 ) {
+            if ( verboseLevel > 6 )
+                logerror( "      EOF on hex image\n" );
+            return total;
+        }
+        if ( type != 0 ) {
+            logerror( "unsupported record type: %d\n", type );
+            return -3;
+        }
+        if ( off + len > FX_MEMORY_SIZE ) {
+            logerror( "record exceeds the address space: 0x%04x\n", off );
+            return -4;
+        }
+        memcpy( image + off, bytes + 4, len );
+        memset( used + off, 1, len );
+        total += int( len );
+    }
+    logerror( "EOF without EOF record!\n" );
+    return total;
+}
+
+/*
+ * Load a firmware image in Intel HEX format from memory into the on-chip RAM
+ * using the first stage loader built into the EZ-USB hardware.
+ * The hex records are parsed once into a memory image, adjacent records are
+ * merged and written with as few control transfers as possible.
+ * The target processor is reset at the end of this upload.
+ */
+int ezusb_load_ram_image( libusb_device_handle *device, const char *hex, size_t size, int fx_type ) {
+    uint32_t cpucs_addr;
+    bool ( *is_external )( uint32_t off, size_t len );
+    struct ram_poke_context ctx;
+    int status;
+
+    switch ( fx_type ) {
+    case FX_TYPE_FX2LP:
+        cpucs_addr = 0xe600;
+        is_external = fx2lp_is_external;
+        break;
+    case FX_TYPE_FX2:
+        cpucs_addr = 0xe600;
+        is_external = fx2_is_external;
+        break;
+    case FX_TYPE_FX3:
+        logerror( "FX3 images are not supported\n" );
+        return -EINVAL;
+    default:
+        cpucs_addr = 0x7f92;
+        is_external = fx_is_external;
+        break;
+    }
+
+    unsigned char *image = static_cast< unsigned char * >( calloc( 2, FX_MEMORY_SIZE ) );
+    if ( image == nullptr )
+        return -ENOMEM;
+    unsigned char *used = image + FX_MEMORY_SIZE;
+    status = parse_ihex_buffer( hex, size, image, used );
+    if ( status < 0 ) {
+        logerror( "unable to parse the firmware image\n" );
+        free( image );
+        return status;
+    }
+    if ( verboseLevel > 6 )
+        logerror( "      firmware image with %d bytes for RAM upload\n", status );
+
+    /* halt the CPU while we overwrite its code/data */
+    if ( !ezusb_cpucs( device, cpucs_addr, false ) ) {
+        free( image );
+        return -1;
+    }
+
+    ctx.device = device;
+    ctx.mode = internal_only;
+    ctx.total = ctx.count = 0;
+    for ( uint32_t addr = 0; addr < FX_MEMORY_SIZE; ) {
+        if ( !used[ addr ] ) {
+            ++addr;
+            continue;
+        }
+        /* merge the adjacent bytes, but do not cross the border between internal and external memory */
+        size_t len = 1;
+        while ( addr + len < FX_MEMORY_SIZE && used[ addr + len ] && len < FX_WRITE_MAX &&
+                is_external( addr, len + 1 ) == is_external( addr, 1 ) )
+            ++len;
+        status = ram_poke( &ctx, addr, is_external( addr, len ), image + addr, len );
+        if ( status < 0 ) {
+            logerror( "unable to upload the firmware image\n" );
+            free( image );
+            return status;
+        }
+        addr += uint32_t( len );
+    }
+    free( image );
+
+    if ( verboseLevel > 6 && ( ctx.count != 0 ) ) {
+        logerror( "      ... WROTE: %d bytes, %d segments, avg %d\n", int( ctx.total ), int( ctx.count ),
+                  int( ctx.total / ctx.count ) );
+    }
+
+    /* reset the CPU so it runs what we just uploaded */
+    if ( !ezusb_cpucs( device, cpucs_addr, true ) )
+        return -1;
+    return 0;
+}
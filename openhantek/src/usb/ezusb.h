@@ -20,6 +20,7 @@
  */
 
 #include <inttypes.h>
+#include <stddef.h>
 
 struct libusb_device_handle;
 #define FX_TYPE_FX2 2   /* USB 2.0 versions */
@@ -36,5 +37,14 @@ struct libusb_device_handle;
  */
 extern int ezusb_load_ram( libusb_device_handle *device, const char *path, int fx_type, int stage );
 
+/*
+ * This function uploads the firmware in Intel HEX format from memory into
+ * the on-chip RAM (single stage load). The image is parsed once, adjacent
+ * records are merged into large control transfers.
+ *
+ * The target processor is reset at the end of this upload.
+ */
+extern int ezusb_load_ram_image( libusb_device_handle *device, const char *hex, size_t size, int fx_type );
+
 // Verbosity level set by command line option --verbose
 extern int verboseLevel;
@@ -10,6 +10,8 @@
 #include "ezusb.h"
 #include "utils/printutils.h"
 #include <algorithm>
+#include <set>
+#include <utility>
 #ifdef Q_OS_FREEBSD
 #include <libusb.h>
 #else
@@ -17,6 +19,7 @@
 #endif
 
 #include "modelregistry.h"
+#include "models/modelPLAYBACK.h"
 
 
 FindDevices::FindDevices( libusb_context *context, int verboseLevel ) : context( context ), verboseLevel( verboseLevel ) {
@@ -25,6 +28,84 @@ FindDevices::FindDevices( libusb_context *context, int verboseLevel ) : context(
 }
 
 
+FindDevices::~FindDevices() {
+    if ( verboseLevel > 1 )
+        qDebug() << " FindDevices::~FindDevices()";
+#if ( LIBUSB_API_VERSION >= 0x01000104 )
+    for ( int handle : hotplugHandles )
+        libusb_hotplug_deregister_callback( context, handle );
+#endif
+}
+
+
+#if ( LIBUSB_API_VERSION >= 0x01000104 )
+// Called by libusb_handle_events_*() in the context of the thread that handles the events, do not access the device here
+static int LIBUSB_CALL hotplugCallback( libusb_context *, libusb_device *, libusb_hotplug_event, void *userData ) {
+    static_cast< FindDevices * >( userData )->notifyHotplug();
+    return 0; // keep the callback registered
+}
+#endif
+
+
+bool FindDevices::enableHotplug() {
+#if ( LIBUSB_API_VERSION >= 0x01000104 )
+    if ( !hotplugHandles.empty() )
+        return true;
+    if ( !libusb_has_capability( LIBUSB_CAP_HAS_HOTPLUG ) )
+        return false;
+    const libusb_pollfd **fds = libusb_get_pollfds( context ); // not available e.g. on windows
+    if ( !fds )
+        return false;
+    for ( const libusb_pollfd **fd = fds; *fd; ++fd )
+        pollFds.push_back( ( *fd )->fd );
+    libusb_free_pollfds( fds );
+    if ( pollFds.empty() )
+        return false;
+    // one filter for each VID/PID pair, with and without firmware
+    std::set< std::pair< unsigned, unsigned > > filters;
+    for ( const DSOModel *model : ModelRegistry::get()->models() ) {
+        if ( DemoDeviceID == model->ID || PlaybackDeviceID == model->ID ) // skip the DEMO and PLAYBACK device
+            continue;
+        filters.insert( std::make_pair( model->vendorID, model->productID ) );
+        filters.insert( std::make_pair( model->vendorIDnoFirmware, model->productIDnoFirmware ) );
+    }
+    for ( const auto &filter : filters ) {
+        libusb_hotplug_callback_handle handle;
+        int status = libusb_hotplug_register_callback(
+            context, libusb_hotplug_event( LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT ),
+            libusb_hotplug_flag( 0 ), int( filter.first ), int( filter.second ), LIBUSB_HOTPLUG_MATCH_ANY, hotplugCallback, this,
+            &handle );
+        if ( status != LIBUSB_SUCCESS ) { // fall back to polling
+            if ( verboseLevel > 1 )
+                qDebug() << " FindDevices::enableHotplug() failed:" << libusb_error_name( status );
+            for ( int registered : hotplugHandles )
+                libusb_hotplug_deregister_callback( context, registered );
+            hotplugHandles.clear();
+            pollFds.clear();
+            return false;
+        }
+        hotplugHandles.push_back( handle );
+    }
+    if ( verboseLevel > 1 )
+        qDebug() << " FindDevices::enableHotplug()" << hotplugHandles.size() << "filters";
+    return !hotplugHandles.empty();
+#else
+    return false;
+#endif
+}
+
+
+bool FindDevices::handleHotplugEvents() {
+    struct timeval tv = { 0, 0 };
+    libusb_handle_events_timeout_completed( context, &tv, nullptr );
+    bool pending = hotplugPending;
+    hotplugPending = false;
+    if ( pending && verboseLevel > 2 )
+        qDebug() << "  FindDevices::handleHotplugEvents()";
+    return pending;
+}
+
+
 // Iterate all devices on USB and keep track of all supported scopes
 int FindDevices::updateDeviceList() {
     if ( verboseLevel > 2 )
@@ -59,7 +140,7 @@ int FindDevices::updateDeviceList() {
         }
         // else check against all supported models for match
         for ( DSOModel *model : ModelRegistry::get()->models() ) {
-            if ( DemoDeviceID == model->ID ) // skip the DEMO device
+            if ( DemoDeviceID == model->ID || PlaybackDeviceID == model->ID ) // skip the DEMO and PLAYBACK device
                 continue;
             // Check VID and PID for firmware flashed devices
             bool supported = descriptor.idVendor == model->vendorID && descriptor.idProduct == model->productID;
@@ -69,7 +150,7 @@ int FindDevices::updateDeviceList() {
                 ++changes;
                 if ( verboseLevel > 2 )
                     qDebug() << "  +++" << QString( "0x%1" ).arg( USBid, 8, 16, QChar( '0' ) ) << model->name;
-                devices[ USBid ] = std::unique_ptr< ScopeDevice >( new ScopeDevice( model, device, findIteration ) );
+                devices[ USBid ] = std::unique_ptr< ScopeDevice >( new ScopeDevice( model, device, findIteration, context ) );
                 break; // stop after 1st supported model (there can be more models with identical VID/PID)
             }
         }
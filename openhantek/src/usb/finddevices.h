@@ -6,6 +6,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "scopedevice.h"
 
@@ -18,12 +19,17 @@ struct libusb_context;
  * If you have found your favorite device, you want to call `takeDevice`. The device will
  * not be available in `getDevices` anymore and this will not change with calls to `updateDeviceList`.
  *
+ * If the platform supports it, `enableHotplug` registers libusb hotplug callbacks for all supported VID/PID pairs.
+ * The caller watches the file descriptors from `getPollFds` and calls `handleHotplugEvents` if they become readable,
+ * `updateDeviceList` is then only needed after a bus change. Without hotplug support the caller has to poll.
+ *
  * Do not close the given usb context before this class object is destroyed.
  */
 class FindDevices {
   public:
     typedef std::map< UniqueUSBid, std::unique_ptr< ScopeDevice > > DeviceList;
     explicit FindDevices( libusb_context *context, int verboseLevel = 0 );
+    ~FindDevices();
     /// Updates the device list. To clear the list, just dispose this object
     /// \return If negative it represents a libusb error code otherwise the amount of updates
     int updateDeviceList();
@@ -35,9 +41,24 @@ class FindDevices {
      */
     std::unique_ptr< ScopeDevice > takeDevice( UniqueUSBid id );
 
+    /// Register the hotplug callbacks with VID/PID filters built from the registered models
+    /// \return false if hotplug is not supported, the device list must be polled
+    bool enableHotplug();
+    bool hasHotplug() const { return !hotplugHandles.empty(); }
+    /// The file descriptors used by libusb for event notification, watch them for read events
+    const std::vector< int > &getPollFds() const { return pollFds; }
+    /// Process the pending libusb events without blocking
+    /// \return true if a supported device has arrived or left since the last call
+    bool handleHotplugEvents();
+    /// Called by the libusb hotplug callback
+    void notifyHotplug() { hotplugPending = true; }
+
   private:
     libusb_context *context; ///< The usb context used for this device
     DeviceList devices;
     unsigned findIteration = 0;
     int verboseLevel = 0;
+    std::vector< int > hotplugHandles;
+    std::vector< int > pollFds;
+    bool hotplugPending = false;
 };
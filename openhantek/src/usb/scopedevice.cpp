@@ -2,12 +2,16 @@
 
 #include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QList>
+#include <cstring>
 #include <iostream>
 
 #include "scopedevice.h"
 
 #include "hantekdso/dsomodel.h"
+#include "hantekdso/models/modelPLAYBACK.h"
+#include "hantekdso/rawplayer.h"
 #include "hantekprotocol/controlStructs.h"
 
 #include <QCoreApplication>
@@ -53,14 +57,25 @@ UniqueUSBid ScopeDevice::computeUSBdeviceID( libusb_device *device ) {
 }
 
 
-ScopeDevice::ScopeDevice( DSOModel *model, libusb_device *device, unsigned findIteration )
-    : model( model ), device( device ), findIteration( findIteration ), uniqueUSBdeviceID( computeUSBdeviceID( device ) ) {
+ScopeDevice::ScopeDevice( DSOModel *model, libusb_device *device, unsigned findIteration, libusb_context *context )
+    : model( model ), device( device ), findIteration( findIteration ), uniqueUSBdeviceID( computeUSBdeviceID( device ) ),
+      context( context ) {
+    statisticsTimer.start();
     libusb_ref_device( device );
     libusb_get_device_descriptor( device, &descriptor );
 }
 
 
-ScopeDevice::ScopeDevice() : model( new ModelDEMO ), device( nullptr ), uniqueUSBdeviceID( 0 ), realHW( false ) {}
+ScopeDevice::ScopeDevice() : model( new ModelDEMO ), device( nullptr ), uniqueUSBdeviceID( 0 ), realHW( false ) {
+    statisticsTimer.start();
+}
+
+
+ScopeDevice::ScopeDevice( RawPlayer *player )
+    : model( new ModelPLAYBACK( QString::fromLatin1( player->getFileHeader().model ) ) ), device( nullptr ), uniqueUSBdeviceID( 0 ),
+      player( player ), realHW( false ) {
+    statisticsTimer.start();
+}
 
 
 bool ScopeDevice::connectDevice( QString &errorMessage ) {
@@ -148,6 +163,7 @@ void ScopeDevice::disconnectFromDevice() {
         return;
 
     if ( handle ) {
+        stopStreaming(); // cancel all async transfers before closing the handle
         // Release claimed interface
         if ( nInterface != -1 )
             libusb_release_interface( handle, nInterface );
@@ -181,9 +197,13 @@ int ScopeDevice::bulkTransfer( unsigned char endpoint, const unsigned char *data
 
     int errorCode = LIBUSB_ERROR_TIMEOUT;
     int transferred = 0;
-    for ( int attempt = 0; ( attempt < attempts || attempts == -1 ) && errorCode == LIBUSB_ERROR_TIMEOUT; ++attempt )
+    int attempt;
+    const int64_t start = statisticsTimer.nsecsElapsed();
+    for ( attempt = 0; ( attempt < attempts || attempts == -1 ) && errorCode == LIBUSB_ERROR_TIMEOUT; ++attempt )
         errorCode =
             libusb_bulk_transfer( handle, endpoint, const_cast< unsigned char * >( data ), int( length ), &transferred, timeout );
+    if ( endpoint & LIBUSB_ENDPOINT_IN )
+        addTransferStatistics( statisticsTimer.nsecsElapsed() - start, errorCode < 0 ? errorCode : transferred, attempt - 1 );
 
     if ( errorCode == LIBUSB_ERROR_NO_DEVICE )
         disconnectFromDevice();
@@ -194,22 +214,21 @@ int ScopeDevice::bulkTransfer( unsigned char endpoint, const unsigned char *data
 }
 
 
-int ScopeDevice::bulkReadMulti( unsigned char *data, unsigned length, bool captureSmallBlocks, unsigned &received, int attempts ) {
+int ScopeDevice::bulkReadMulti( unsigned char *data, unsigned length, unsigned chunkSize, unsigned &received, int attempts ) {
     if ( !handle || disconnected )
         return LIBUSB_ERROR_NO_DEVICE;
     int retCode = 0;
     if ( verboseLevel > 6 )
         qDebug() << "      ScopeDevice::bulkReadMulti()" << length;
-    if ( captureSmallBlocks ) { // used in roll mode
+    if ( chunkSize ) { // used in roll mode
         // slow data is read in smaller chunks to enable quick screen update
-        const unsigned packetLength = 512 * 78; // ~200 samples on screen (200x oversampling)
-        retCode = int( packetLength );
+        retCode = int( chunkSize );
         unsigned int packet;
         received = 0;
-        for ( packet = 0; received < length && retCode == int( packetLength ); ++packet ) {
+        for ( packet = 0; received < length && retCode == int( chunkSize ); ++packet ) {
             if ( hasStopped() )
                 break;
-            retCode = bulkTransfer( HANTEK_EP_IN, data + packet * packetLength, qMin( length - unsigned( received ), packetLength ),
+            retCode = bulkTransfer( HANTEK_EP_IN, data + packet * chunkSize, qMin( length - unsigned( received ), chunkSize ),
                                     attempts, HANTEK_TIMEOUT_MULTI * 10 );
             if ( retCode > 0 )
                 received += unsigned( retCode );
@@ -236,6 +255,225 @@ int ScopeDevice::bulkReadMulti( unsigned char *data, unsigned length, bool captu
 }
 
 
+unsigned ScopeDevice::rollChunkSize( double byteRate ) {
+    // slow rates: small chunks for a smooth screen update, fast rates: big chunks to keep the transfer overhead low
+    unsigned chunkSize = unsigned( byteRate * HANTEK_ROLL_LATENCY / 1000 ) / HANTEK_ROLL_CHUNK_MIN * HANTEK_ROLL_CHUNK_MIN;
+    return qBound( unsigned( HANTEK_ROLL_CHUNK_MIN ), chunkSize, unsigned( HANTEK_ROLL_CHUNK_MAX ) );
+}
+
+
+// Map the status of an async transfer to the error codes of the sync API
+static int transferStatusToError( libusb_transfer_status status ) {
+    switch ( status ) {
+    case LIBUSB_TRANSFER_COMPLETED:
+        return LIBUSB_SUCCESS;
+    case LIBUSB_TRANSFER_TIMED_OUT:
+        return LIBUSB_ERROR_TIMEOUT;
+    case LIBUSB_TRANSFER_STALL:
+        return LIBUSB_ERROR_PIPE;
+    case LIBUSB_TRANSFER_NO_DEVICE:
+        return LIBUSB_ERROR_NO_DEVICE;
+    case LIBUSB_TRANSFER_OVERFLOW:
+        return LIBUSB_ERROR_OVERFLOW;
+    case LIBUSB_TRANSFER_CANCELLED:
+        return LIBUSB_ERROR_INTERRUPTED;
+    default:
+        return LIBUSB_ERROR_IO;
+    }
+}
+
+
+// Transfer completion, called by libusb_handle_events_*() in the context of the capturing thread
+void LIBUSB_CALL ScopeDevice::streamCallback( libusb_transfer *transfer ) {
+    StreamTransfer *streamTransfer = static_cast< StreamTransfer * >( transfer->user_data );
+    ScopeDevice *scopeDevice = streamTransfer->device;
+    streamTransfer->pending = false;
+    if ( transfer->status != LIBUSB_TRANSFER_CANCELLED ) // do not count the cleanup of the ring
+        scopeDevice->addTransferStatistics( scopeDevice->statisticsTimer.nsecsElapsed() - streamTransfer->submitted,
+                                            transfer->status == LIBUSB_TRANSFER_COMPLETED
+                                                ? transfer->actual_length
+                                                : transferStatusToError( transfer->status ),
+                                            0 );
+    if ( --scopeDevice->streamInFlight == 0 && transfer->status == LIBUSB_TRANSFER_COMPLETED )
+        ++scopeDevice->streamOverruns; // the ring has run dry, the device FIFO may overflow
+    if ( verboseLevel > 7 )
+        qDebug() << "        ScopeDevice::streamCallback()" << transfer->status << transfer->actual_length
+                 << scopeDevice->streamInFlight;
+}
+
+
+int ScopeDevice::startStreaming( unsigned transferSize, unsigned transferCount ) {
+    if ( !handle || disconnected )
+        return LIBUSB_ERROR_NO_DEVICE;
+    stopStreaming();
+    if ( inPacketLength ) // read only complete packets
+        transferSize = ( transferSize + inPacketLength - 1 ) / inPacketLength * inPacketLength;
+    if ( verboseLevel > 6 )
+        qDebug() << "      ScopeDevice::startStreaming()" << transferCount << "x" << transferSize;
+    streamRing.resize( qMax( transferCount, 2U ) ); // not resized again while streaming, pointers stay valid
+    streamIndex = 0;
+    streamOffset = 0;
+    for ( StreamTransfer &streamTransfer : streamRing ) {
+        streamTransfer.device = this;
+        streamTransfer.transfer = libusb_alloc_transfer( 0 );
+        unsigned char *buffer = static_cast< unsigned char * >( malloc( transferSize ) );
+        if ( !streamTransfer.transfer || !buffer ) {
+            free( buffer );
+            stopStreaming();
+            return LIBUSB_ERROR_NO_MEM;
+        }
+        libusb_fill_bulk_transfer( streamTransfer.transfer, handle, HANTEK_EP_IN, buffer, int( transferSize ), streamCallback,
+                                   &streamTransfer, 0 );
+        streamTransfer.transfer->flags = LIBUSB_TRANSFER_FREE_BUFFER; // libusb_free_transfer() frees also the buffer
+        int errorCode = libusb_submit_transfer( streamTransfer.transfer );
+        if ( errorCode < 0 ) {
+            stopStreaming();
+            return errorCode;
+        }
+        streamTransfer.pending = true;
+        streamTransfer.submitted = statisticsTimer.nsecsElapsed();
+        ++streamInFlight;
+    }
+    return LIBUSB_SUCCESS;
+}
+
+
+void ScopeDevice::stopStreaming() {
+    if ( streamRing.empty() )
+        return;
+    if ( verboseLevel > 6 )
+        qDebug() << "      ScopeDevice::stopStreaming()" << streamInFlight << "pending, overruns:" << streamOverruns;
+    for ( StreamTransfer &streamTransfer : streamRing ) {
+        if ( streamTransfer.pending )
+            libusb_cancel_transfer( streamTransfer.transfer );
+    }
+    // the cancelled transfers must be reaped before they can be freed
+    for ( int wait = 0; streamInFlight && wait < 100; ++wait ) {
+        struct timeval tv = { 0, 10000 }; // 10 ms
+        libusb_handle_events_timeout_completed( context, &tv, nullptr );
+    }
+    for ( StreamTransfer &streamTransfer : streamRing ) {
+        if ( streamTransfer.pending ) // do not free a transfer that is still owned by libusb, leak it instead
+            qWarning() << "ScopeDevice::stopStreaming(): transfer not cancelled";
+        else if ( streamTransfer.transfer )
+            libusb_free_transfer( streamTransfer.transfer );
+    }
+    streamRing.clear();
+    streamInFlight = 0;
+}
+
+
+int ScopeDevice::bulkReadStream( unsigned char *data, unsigned length, unsigned &received ) {
+    if ( !handle || disconnected )
+        return LIBUSB_ERROR_NO_DEVICE;
+    if ( !isStreaming() )
+        return LIBUSB_ERROR_NOT_FOUND;
+    if ( verboseLevel > 6 )
+        qDebug() << "      ScopeDevice::bulkReadStream()" << length;
+    received = 0;
+    QElapsedTimer stalled; // no completed transfer for HANTEK_TIMEOUT_MULTI -> error
+    stalled.start();
+    while ( received < length ) {
+        if ( hasStopped() ) { // discard the data already in the ring, restart with new settings
+            stopStreaming();
+            return 0;
+        }
+        StreamTransfer &current = streamRing[ streamIndex ];
+        if ( current.pending ) { // wait for completion
+            struct timeval tv = { 0, 10000 }; // 10 ms, check hasStopped() regularly
+            int errorCode = libusb_handle_events_timeout_completed( context, &tv, nullptr );
+            if ( errorCode == LIBUSB_ERROR_INTERRUPTED )
+                continue;
+            if ( errorCode >= 0 && stalled.elapsed() > HANTEK_TIMEOUT_MULTI )
+                errorCode = LIBUSB_ERROR_TIMEOUT;
+            if ( errorCode < 0 ) {
+                stopStreaming();
+                return errorCode;
+            }
+            continue;
+        }
+        if ( current.transfer->status != LIBUSB_TRANSFER_COMPLETED ) {
+            int errorCode = transferStatusToError( current.transfer->status );
+            stopStreaming();
+            if ( errorCode == LIBUSB_ERROR_NO_DEVICE )
+                disconnectFromDevice();
+            return errorCode;
+        }
+        unsigned chunk = qMin( unsigned( current.transfer->actual_length ) - streamOffset, length - received );
+        memcpy( data + received, current.transfer->buffer + streamOffset, chunk );
+        received += chunk;
+        streamOffset += chunk;
+        if ( streamOffset >= unsigned( current.transfer->actual_length ) ) { // transfer emptied, put it back into the ring
+            streamOffset = 0;
+            int errorCode = libusb_submit_transfer( current.transfer );
+            if ( errorCode < 0 ) {
+                stopStreaming();
+                return errorCode;
+            }
+            current.pending = true;
+            current.submitted = statisticsTimer.nsecsElapsed();
+            ++streamInFlight;
+            streamIndex = ( streamIndex + 1 ) % unsigned( streamRing.size() );
+            stalled.restart();
+        }
+    }
+    if ( verboseLevel > 6 )
+        qDebug() << "      ScopeDevice::bulkReadStream() received" << received << "overruns" << streamOverruns;
+    return int( received );
+}
+
+
+void ScopeDevice::addTransferStatistics( int64_t latency, int result, int retries ) {
+    QMutexLocker locker( &statisticsMutex );
+    if ( result >= 0 ) {
+        ++statistics.transfers;
+        statistics.bytes += unsigned( result );
+    } else if ( result == LIBUSB_ERROR_TIMEOUT ) {
+        ++statistics.timeouts;
+    } else {
+        ++statistics.errors;
+    }
+    if ( retries > 0 )
+        statistics.retries += unsigned( retries );
+    ++statistics.latencyHistogram[ TransferStatistics::latencyBucket( latency ) ];
+    statistics.latencyMax = qMax( statistics.latencyMax, latency );
+}
+
+
+void ScopeDevice::blockStarted() {
+    QMutexLocker locker( &statisticsMutex );
+    blockStart = statisticsTimer.nsecsElapsed();
+    if ( blockEnd >= 0 ) { // time between the blocks
+        statistics.blockGap = blockStart - blockEnd;
+        statistics.blockGapMax = qMax( statistics.blockGapMax, statistics.blockGap );
+        statistics.deadTime += statistics.blockGap;
+    }
+}
+
+
+void ScopeDevice::blockFinished() {
+    QMutexLocker locker( &statisticsMutex );
+    blockEnd = statisticsTimer.nsecsElapsed();
+    statistics.captureTime += blockEnd - blockStart;
+    ++statistics.blocks;
+}
+
+
+TransferStatistics ScopeDevice::getTransferStatistics() const {
+    QMutexLocker locker( &statisticsMutex );
+    TransferStatistics snapshot = statistics;
+    snapshot.time = statisticsTimer.nsecsElapsed();
+    return snapshot;
+}
+
+
+void ScopeDevice::resetTransferStatistics() {
+    QMutexLocker locker( &statisticsMutex );
+    statistics = TransferStatistics();
+    blockEnd = -1;
+}
+
+
 // static QString hexString( unsigned char byte ) { return QString( "0x%1" ).arg( byte, 2, 16, QLatin1Char( '0' ) ); }
 
 static QString usbTypeString( int type ) {
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QObject>
 #include <QReadWriteLock>
@@ -13,11 +14,14 @@
 #include <libusb-1.0/libusb.h>
 #endif
 #include <memory>
+#include <vector>
 
 #include "models/modelDEMO.h"
+#include "transferstatistics.h"
 #include "usbdevicedefinitions.h"
 
 class DSOModel;
+class RawPlayer;
 
 typedef uint64_t UniqueUSBid;
 
@@ -34,8 +38,10 @@ class ScopeDevice : public QObject {
     Q_OBJECT
 
   public:
-    explicit ScopeDevice( DSOModel *model, libusb_device *device, unsigned findIteration = 0 );
+    explicit ScopeDevice( DSOModel *model, libusb_device *device, unsigned findIteration = 0, libusb_context *context = nullptr );
     explicit ScopeDevice();
+    /// \brief Playback device, replays a raw sample recording, takes the ownership of the opened player.
+    explicit ScopeDevice( RawPlayer *player );
     ScopeDevice( const ScopeDevice & ) = delete;
     ~ScopeDevice() override;
     bool connectDevice( QString &errorMessage );
@@ -48,6 +54,12 @@ class ScopeDevice : public QObject {
     /// \brief Distinguish between real hw or demo device
     bool isRealHW() const { return realHW; }
     bool isDemoDevice() const { return !realHW; }
+    bool isPlayback() const { return player != nullptr; }
+    RawPlayer *getPlayer() const { return player.get(); }
+
+    /// \brief Demo and playback device: deliver the samples as fast as possible instead of in real time.
+    void setUnthrottled( bool enable ) { unthrottled = enable && !realHW; }
+    bool isUnthrottled() const { return unthrottled; }
 
     /// \brief Stop a long running (interruptible) bulk transfer
     void stopSampling() { stopTransfer = true; }
@@ -93,13 +105,57 @@ class ScopeDevice : public QObject {
     /// \brief Multi packet bulk read from the oscilloscope.
     /// \param data Buffer for the sent/received data.
     /// \param length The length of data contained in the packets.
-    /// \param captureSmallBlocks Capture many small blocks instead of one big block (faster gui update)
+    /// \param chunkSize Capture many small chunks of this size instead of one big block (faster gui update), 0: one block
     /// \param received The amount of already captured samples
     /// \param attempts The number of attempts, that are done on timeouts.
     /// \return Number of received bytes on success, libusb error code on error.
-    int bulkReadMulti( unsigned char *data, unsigned length, bool captureSmallBlocks, unsigned &received,
+    int bulkReadMulti( unsigned char *data, unsigned length, unsigned chunkSize, unsigned &received,
                        int attempts = HANTEK_ATTEMPTS_MULTI );
 
+    /// \brief Size of the roll mode chunks that fill about HANTEK_ROLL_LATENCY ms of data.
+    /// The size is a multiple of the USB packet size, limited by HANTEK_ROLL_CHUNK_MIN and HANTEK_ROLL_CHUNK_MAX.
+    /// \param byteRate The rate of the raw data (samplerate * channels) in bytes per second.
+    static unsigned rollChunkSize( double byteRate );
+
+    /// \brief Use continuous sampling with asynchronous bulk transfers for fast (non roll mode) sampling.
+    /// \param enable true to use the streaming engine.
+    void setStreamingMode( bool enable ) { streamingMode = enable && realHW; }
+    bool isStreamingMode() const { return streamingMode; }
+
+    /// \brief Submit a ring of asynchronous bulk transfers that are kept in flight.
+    /// The device must be started with CONTROL_STARTSAMPLING after this call.
+    /// \param transferSize The size of one transfer, will be rounded up to full IN packets.
+    /// \param transferCount The number of transfers in the ring.
+    /// \return LIBUSB_SUCCESS on success, libusb error code on error.
+    int startStreaming( unsigned transferSize, unsigned transferCount = HANTEK_STREAM_TRANSFERS );
+
+    /// \brief Cancel all transfers in flight and release the ring.
+    void stopStreaming();
+
+    /// \brief Check if the transfer ring is active.
+    bool isStreaming() const { return !streamRing.empty(); }
+
+    /// \brief Get a snapshot of the transfer statistics, can be called from any thread.
+    TransferStatistics getTransferStatistics() const;
+    void resetTransferStatistics();
+
+    /// \brief Statistics: the capturing of one block starts.
+    void blockStarted();
+    /// \brief Statistics: the capturing of one block has finished.
+    void blockFinished();
+
+    /// \brief Read the next data from the stream of completed transfers, resubmit the emptied transfers.
+    /// \param data Buffer for the received data.
+    /// \param length The number of bytes to read.
+    /// \param received The amount of already captured samples
+    /// \return Number of received bytes on success, libusb error code on error.
+    int bulkReadStream( unsigned char *data, unsigned length, unsigned &received );
+
+    /// \brief Total number of stream overruns.
+    /// An overrun is counted if all transfers of the ring had completed before they were read,
+    /// i.e. no transfer was pending and the device FIFO could overflow -> gap in the data stream.
+    unsigned getStreamOverruns() const { return streamOverruns; }
+
     /// \brief Control transfer to the oscilloscope.
     /// \param type The request type, also sets the direction of the transfer.
     /// \param request The request field of the packet.
@@ -200,6 +256,31 @@ class ScopeDevice : public QObject {
         return bulkTransfer( HANTEK_EP_IN, command->data(), command->size(), attempts );
     }
 
+    /// \brief One asynchronous transfer of the streaming ring
+    struct StreamTransfer {
+        ScopeDevice *device = nullptr;
+        libusb_transfer *transfer = nullptr; ///< Owns also the data buffer
+        bool pending = false;                ///< Submitted, not yet completed
+        int64_t submitted = 0;               ///< Statistics: time of submission
+    };
+    static void LIBUSB_CALL streamCallback( libusb_transfer *transfer );
+    void addTransferStatistics( int64_t latency, int result, int retries );
+    libusb_context *context = nullptr; ///< The usb context, needed for async event handling
+    std::vector< StreamTransfer > streamRing;
+    unsigned streamIndex = 0;    ///< Ring position of the oldest transfer (next to read)
+    unsigned streamOffset = 0;   ///< Bytes already read from the oldest transfer
+    unsigned streamInFlight = 0; ///< Number of pending transfers
+    unsigned streamOverruns = 0;
+    bool streamingMode = false;
+
+    mutable QMutex statisticsMutex;
+    TransferStatistics statistics;
+    QElapsedTimer statisticsTimer;
+    int64_t blockStart = 0;
+    int64_t blockEnd = -1; ///< End of the last block, -1: no block yet
+
+    std::unique_ptr< RawPlayer > player; ///< Replays a recording instead of sampling
+    bool unthrottled = false;
     bool realHW = true;
     bool stopTransfer = false;
     bool disconnected = true;
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+
+/// \brief Statistics of the USB bulk transfers and of the block capturing.
+/// The counters are cheap enough to be always active, all times are in ns.
+struct TransferStatistics {
+    static const unsigned LATENCY_BUCKETS = 16; ///< histogram bucket n: latency < 2^n * 100 µs, the last one: longer
+
+    int64_t time = 0;                                  ///< time of this snapshot since start of the statistics
+    uint64_t transfers = 0;                            ///< number of completed bulk IN transfers
+    uint64_t bytes = 0;                                ///< received bytes
+    uint64_t retries = 0;                              ///< transfer attempts repeated after a timeout
+    uint64_t timeouts = 0;                             ///< transfers that failed with timeout after all attempts
+    uint64_t errors = 0;                               ///< transfers that failed with other errors
+    uint64_t latencyHistogram[ LATENCY_BUCKETS ] = {}; ///< duration of all transfers, also the failed ones
+    int64_t latencyMax = 0;                            ///< longest transfer
+    uint64_t blocks = 0;                               ///< number of captured blocks
+    int64_t blockGap = 0;                              ///< gap between the last two blocks
+    int64_t blockGapMax = 0;                           ///< longest gap between two blocks
+    int64_t captureTime = 0;                           ///< time spent capturing the blocks
+    int64_t deadTime = 0;                              ///< time spent between the blocks (e.g. sending commands)
+
+    static unsigned latencyBucket( int64_t latency ) {
+        unsigned bucket = 0;
+        for ( int64_t limit = 100000; latency >= limit && bucket < LATENCY_BUCKETS - 1; limit *= 2 )
+            ++bucket;
+        return bucket;
+    }
+
+    /// \brief Upper limit of the latency for the given fraction of all transfers (e.g. 0.9 for 90 %).
+    int64_t latencyPercentile( double fraction ) const {
+        const uint64_t total = transfers + timeouts + errors; // the histogram counts also the failed transfers
+        uint64_t count = 0;
+        int64_t limit = 100000;
+        for ( unsigned bucket = 0; bucket < LATENCY_BUCKETS - 1; ++bucket, limit *= 2 ) {
+            count += latencyHistogram[ bucket ];
+            if ( count >= fraction * total )
+                return limit;
+        }
+        return latencyMax;
+    }
+
+    /// \brief Part of the time that was used for capturing (0..1).
+    double captureRatio() const {
+        return captureTime + deadTime > 0 ? double( captureTime ) / double( captureTime + deadTime ) : 0.0;
+    }
+};
@@ -2,14 +2,13 @@
 
 #include <QCoreApplication>
 #include <QDebug>
+#include <QFile>
 #include <QString>
-#include <QTemporaryFile>
 #ifdef Q_OS_FREEBSD
 #include <libusb.h>
 #else
 #include <libusb-1.0/libusb.h>
 #endif
-#include <memory>
 
 #include "ezusb.h"
 #include "scopedevice.h"
@@ -32,12 +31,15 @@ bool UploadFirmware::startUpload( ScopeDevice *scopeDevice ) {
         return false;
     }
 
-    // Write firmware from resources to temp files
+    // Read the firmware image from resources into memory, no temporary file needed
     QFile firmwareRes( QString( ":/firmware/%1-firmware.hex" ).arg( scopeDevice->getModel()->firmwareToken ) );
-    auto temp_firmware_path = std::unique_ptr< QTemporaryFile >( QTemporaryFile::createNativeFile( firmwareRes ) );
-    if ( !temp_firmware_path )
+    if ( !firmwareRes.open( QIODevice::ReadOnly ) ) {
+        errorMessage = TR( "Couldn't read firmware %1" ).arg( firmwareRes.fileName() );
+        libusb_close( handle );
         return false;
-    temp_firmware_path->open();
+    }
+    const QByteArray firmware = firmwareRes.readAll();
+    firmwareRes.close();
 
 #ifdef Q_OS_LINUX
     // Detach kernel driver, reported to lead to an error on FreeBSD, MacOSX and Windows
@@ -58,8 +60,8 @@ bool UploadFirmware::startUpload( ScopeDevice *scopeDevice ) {
     }
 
     // Write firmware into internal RAM using first stage loader built into EZ-USB hardware
-    // use local 8bit encoding (utf8 for Linux, iso-8859-x for Windows)
-    status = ezusb_load_ram( handle, temp_firmware_path->fileName().toLocal8Bit().constData(), FX_TYPE_FX2LP, 0 );
+    // adjacent hex records are merged and uploaded with few large control transfers
+    status = ezusb_load_ram_image( handle, firmware.constData(), size_t( firmware.size() ), FX_TYPE_FX2LP );
     if ( status != LIBUSB_SUCCESS ) {
         errorMessage = TR( "Writing the main firmware failed: %1" ).arg( libusb_error_name( status ) );
         libusb_release_interface( handle, 0 );
@@ -7,6 +7,14 @@
 #define HANTEK_ATTEMPTS 3        ///< The number of transfer attempts
 #define HANTEK_ATTEMPTS_MULTI 1  ///< The number of multi packet transfer attempts
 
+#define HANTEK_STREAM_TRANSFERS 8                  ///< Number of asynchronous transfers kept in flight when streaming
+#define HANTEK_STREAM_TRANSFER_MIN ( 16 * 1024 )   ///< Minimal size of one streaming transfer in bytes
+#define HANTEK_STREAM_TRANSFER_MAX ( 1024 * 1024 ) ///< Maximal size of one streaming transfer in bytes
+
+#define HANTEK_ROLL_LATENCY 20               ///< Target time between two roll mode screen updates in ms
+#define HANTEK_ROLL_CHUNK_MIN 512            ///< Minimal size of one roll mode transfer in bytes (one HS packet)
+#define HANTEK_ROLL_CHUNK_MAX ( 128 * 1024 ) ///< Maximal size of one roll mode transfer in bytes
+
 #define HANTEK_EP_OUT 0x02 ///< OUT Endpoint for bulk transfers
 #define HANTEK_EP_IN 0x86  ///< IN Endpoint for bulk transfers
 
@@ -2,6 +2,8 @@
 
 #pragma once
 #include <cerrno>
+#include <chrono>
+#include <cstdint>
 
 #include <QString>
 #include <QTime>
@@ -42,6 +44,12 @@ QString hexdecDump( unsigned char *data, unsigned int length );
 /// \return The length of the saved data.
 unsigned int hexParse( const QString dump, unsigned char *data, unsigned int length );
 
+/// \brief Time of the steady (monotonic) system clock, e.g. CLOCK_MONOTONIC on Linux.
+/// \return The time in ns since an unspecified start, e.g. the system boot.
+inline int64_t steadyTime() {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
 /// \brief Print debug information with timestamp.
 /// \param text Text that will be output via qDebug.
 #ifdef TIMESTAMPDEBUG
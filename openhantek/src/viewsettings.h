@@ -50,6 +50,7 @@ struct DsoSettingsView {
     bool zoomImage = true;                                            ///< Export zoomed images with double height
     bool zoom = false;                                                ///< true if the magnified scope is enabled
     int exportScaleValue = 1;
+    bool exportBlockInfo = false;                                     ///< CSV and JSON export: add block number and acquisition time
     Qt::ToolBarArea cursorGridPosition = Qt::RightToolBarArea;
     bool cursorsVisible = false;
     DsoSettingsColorValues *colors = &screen;
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "rawqueue.h"
+
+#include <QtTest>
+#include <thread>
+
+
+class TestRawQueue : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void empty();
+    void newestBlock();
+    void everyBlock();
+    void readBlockStaysValid();
+    void concurrentNewest();
+    void concurrentEvery();
+
+  private:
+    void concurrent( bool every );
+};
+
+
+static void publish( RawQueue &queue, unsigned tag ) {
+    Raw *raw = queue.writeBlock();
+    raw->tag = tag;
+    raw->data.assign( 16, uint8_t( tag ) );
+    queue.commitBlock();
+}
+
+
+void TestRawQueue::empty() {
+    RawQueue queue;
+    QVERIFY( queue.readBlock() == nullptr );
+    queue.writeBlock(); // not yet published
+    QVERIFY( queue.readBlock() == nullptr );
+    queue.commitBlock();
+    QVERIFY( queue.readBlock() != nullptr );
+}
+
+
+void TestRawQueue::newestBlock() {
+    RawQueue queue( 3 );
+    for ( unsigned tag = 1; tag <= 4; ++tag ) // the 4th block reuses the oldest unread block
+        publish( queue, tag );
+    QCOMPARE( queue.getDropped(), 1u );
+    const Raw *raw = queue.readBlock();
+    QVERIFY( raw != nullptr );
+    QCOMPARE( raw->tag, 4u );
+    QCOMPARE( queue.getDropped(), 3u ); // blocks 2 and 3 were never read
+    QCOMPARE( queue.readBlock(), raw ); // nothing new
+    publish( queue, 5 );
+    QCOMPARE( queue.readBlock()->tag, 5u );
+}
+
+
+void TestRawQueue::everyBlock() {
+    RawQueue queue( 3 );
+    queue.setEveryBlock( true );
+    for ( unsigned tag = 1; tag <= 4; ++tag ) // the 4th block does not fit and is dropped
+        publish( queue, tag );
+    QCOMPARE( queue.getDropped(), 1u );
+    QCOMPARE( queue.readBlock()->tag, 1u );
+    QCOMPARE( queue.readBlock()->tag, 2u );
+    publish( queue, 5 ); // uses the slot of block 1
+    QCOMPARE( queue.readBlock()->tag, 3u );
+    QCOMPARE( queue.readBlock()->tag, 5u );
+    QCOMPARE( queue.readBlock()->tag, 5u ); // nothing new
+    QCOMPARE( queue.getDropped(), 1u );
+}
+
+
+void TestRawQueue::readBlockStaysValid() {
+    RawQueue queue( 3 );
+    publish( queue, 1 );
+    const Raw *raw = queue.readBlock();
+    for ( unsigned tag = 2; tag < 100; ++tag ) // the producer cycles through the two other slots
+        publish( queue, tag );
+    QCOMPARE( raw->tag, 1u );
+    QCOMPARE( raw->data[ 0 ], uint8_t( 1 ) );
+    QCOMPARE( queue.readBlock()->tag, 99u );
+}
+
+
+void TestRawQueue::concurrent( bool every ) {
+    const unsigned blocks = 200000;
+    RawQueue queue( 3 );
+    queue.setEveryBlock( every );
+    std::atomic< bool > done{ false };
+    std::thread producer( [ & ]() {
+        for ( unsigned tag = 1; tag <= blocks; ++tag ) {
+            Raw *raw = queue.writeBlock();
+            raw->tag = tag;
+            raw->size = tag * 7;
+            queue.commitBlock();
+        }
+        done = true;
+    } );
+    unsigned last = 0;
+    unsigned read = 0;
+    unsigned bad = 0;
+    for ( ;; ) {
+        const bool finished = done; // all blocks are published if set before the last read
+        const Raw *raw = queue.readBlock();
+        if ( raw && raw->tag != last ) {
+            if ( raw->size != raw->tag * 7 || raw->tag < last ) // torn or reordered block
+                ++bad;
+            last = raw->tag;
+            ++read;
+        } else if ( finished ) {
+            break;
+        }
+    }
+    producer.join();
+    QCOMPARE( bad, 0u );
+    if ( every ) // the producer drops only the blocks that do not fit
+        QCOMPARE( read + queue.getDropped(), blocks );
+    else
+        QCOMPARE( last, blocks );
+}
+
+
+void TestRawQueue::concurrentNewest() { concurrent( false ); }
+
+
+void TestRawQueue::concurrentEvery() { concurrent( true ); }
+
+
+QTEST_APPLESS_MAIN( TestRawQueue )
+#include "tst_rawqueue.moc"
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "rawplayer.h"
+#include "rawrecorder.h"
+
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <cstring>
+#include <vector>
+
+
+class TestRawRecorder : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void roundTrip();
+    void segments();
+    void segmentRing();
+
+  private:
+    void record( RawRecorder &recorder, unsigned tag, unsigned size, bool valid = true );
+    void checkBlock( RawPlayer &player, unsigned tag, unsigned size );
+    QTemporaryDir dir;
+};
+
+
+static const unsigned BLOCK = 1000;
+// two blocks of BLOCK samples fit into one segment
+static const qint64 SEGMENT = sizeof( RawFileHeader ) + 2 * ( sizeof( RawBlockHeader ) + BLOCK );
+
+
+// the samples of a block are derived from its tag
+void TestRawRecorder::record( RawRecorder &recorder, unsigned tag, unsigned size, bool valid ) {
+    std::vector< unsigned char > data( size );
+    for ( unsigned index = 0; index < size; ++index )
+        data[ index ] = uint8_t( tag + index );
+    RawBlockHeader header;
+    memset( &header, 0, sizeof( header ) );
+    header.size = size;
+    header.tag = tag;
+    header.samplerate = 1e6 * tag;
+    header.oversampling = 1;
+    header.channels = 2;
+    header.valid = valid;
+    header.gainIndex[ 0 ] = 3;
+    header.gainIndex[ 1 ] = 7;
+    QVERIFY( recorder.write( header, data.data() ) );
+}
+
+
+void TestRawRecorder::checkBlock( RawPlayer &player, unsigned tag, unsigned size ) {
+    const unsigned char *data = nullptr;
+    const RawBlockHeader *header = player.nextBlock( data );
+    QVERIFY( header != nullptr );
+    QCOMPARE( unsigned( header->tag ), tag ); // copies, the header is packed
+    QCOMPARE( unsigned( header->size ), size );
+    QCOMPARE( double( header->samplerate ), 1e6 * tag );
+    QCOMPARE( unsigned( header->valid ), size ? 1u : 0u );
+    QCOMPARE( unsigned( header->gainIndex[ 0 ] ), 3u );
+    QCOMPARE( unsigned( header->gainIndex[ 1 ] ), 7u );
+    for ( unsigned index = 0; index < size; ++index )
+        QCOMPARE( unsigned( data[ index ] ), unsigned( uint8_t( tag + index ) ) );
+}
+
+
+void TestRawRecorder::roundTrip() {
+    QVERIFY( dir.isValid() );
+    const QString fileName = dir.filePath( "roundtrip.ohraw" );
+    Hantek::CalibrationValues calibration;
+    Hantek::CalibrationValues correction;
+    memset( &calibration, 0x81, sizeof( calibration ) );
+    memset( &correction, 0x7F, sizeof( correction ) );
+    RawRecorder recorder;
+    QVERIFY( recorder.start( fileName, "DSO-6022BE", calibration, correction ) );
+    record( recorder, 1, BLOCK );
+    record( recorder, 2, BLOCK / 2, false ); // a gap, the samples are not stored
+    record( recorder, 3, 2 * BLOCK );
+    recorder.stop();
+    QCOMPARE( recorder.getBytesWritten(), qint64( sizeof( RawFileHeader ) + 3 * sizeof( RawBlockHeader ) + 3 * BLOCK ) );
+    QCOMPARE( QFileInfo( fileName ).size(), recorder.getBytesWritten() ); // the reserved space is truncated
+
+    RawPlayer player;
+    QVERIFY( player.open( fileName ) );
+    QCOMPARE( QString( player.getFileHeader().model ), QString( "DSO-6022BE" ) );
+    QVERIFY( 0 == memcmp( &player.getFileHeader().calibration, &calibration, sizeof( calibration ) ) );
+    QVERIFY( 0 == memcmp( &player.getFileHeader().correction, &correction, sizeof( correction ) ) );
+    checkBlock( player, 1, BLOCK );
+    checkBlock( player, 2, 0 );
+    checkBlock( player, 3, 2 * BLOCK );
+    checkBlock( player, 1, BLOCK ); // the replay starts again
+    QCOMPARE( player.getBlocksPlayed(), 4u );
+}
+
+
+void TestRawRecorder::segments() {
+    QVERIFY( dir.isValid() );
+    const QString fileName = dir.filePath( "segments.ohraw" );
+    Hantek::CalibrationValues calibration;
+    memset( &calibration, 0, sizeof( calibration ) );
+    RawRecorder recorder;
+    QVERIFY( recorder.start( fileName, "DSO-6022BL", calibration, calibration, 0, SEGMENT ) );
+    for ( unsigned tag = 1; tag <= 5; ++tag )
+        record( recorder, tag, BLOCK );
+    recorder.stop();
+    QVERIFY( QFile::exists( RawRecorder::segmentFileName( fileName, 2 ) ) );
+    QVERIFY( !QFile::exists( RawRecorder::segmentFileName( fileName, 3 ) ) );
+
+    RawPlayer player;
+    QVERIFY( player.open( fileName ) );
+    for ( unsigned tag = 1; tag <= 5; ++tag )
+        checkBlock( player, tag, BLOCK );
+    checkBlock( player, 1, BLOCK );
+}
+
+
+void TestRawRecorder::segmentRing() {
+    QVERIFY( dir.isValid() );
+    const QString fileName = dir.filePath( "ring.ohraw" );
+    Hantek::CalibrationValues calibration;
+    memset( &calibration, 0, sizeof( calibration ) );
+    RawRecorder recorder;
+    QVERIFY( recorder.start( fileName, "DSO-6022BL", calibration, calibration, 2, SEGMENT ) );
+    for ( unsigned tag = 1; tag <= 5; ++tag )
+        record( recorder, tag, BLOCK );
+    recorder.stop();
+    QVERIFY( !QFile::exists( fileName ) ); // the oldest segment was removed
+    QVERIFY( QFile::exists( RawRecorder::segmentFileName( fileName, 1 ) ) );
+    QVERIFY( QFile::exists( RawRecorder::segmentFileName( fileName, 2 ) ) );
+
+    RawPlayer player; // the replay starts with the oldest kept segment
+    QVERIFY( player.open( RawRecorder::segmentFileName( fileName, 1 ) ) );
+    for ( unsigned tag = 3; tag <= 5; ++tag )
+        checkBlock( player, tag, BLOCK );
+    checkBlock( player, 3, BLOCK );
+}
+
+
+QTEST_APPLESS_MAIN( TestRawRecorder )
+#include "tst_rawrecorder.moc"
@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "triggerengine.h"
+
+#include <QtTest>
+#include <cmath>
+
+
+class TestTriggerEngine : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void edge();
+    void edgeHysteresis();
+    void edgeAverage();
+    void pulseWidth();
+    void runt();
+    void window();
+    void slewRate();
+    void timeout();
+    void allEvents();
+    void mayTrigger();
+};
+
+
+// pulses of height 1 V on 0 V, each given by its 1st high sample and its width
+static std::vector< Sample > pulses( size_t size, std::initializer_list< std::pair< int, int > > list, Sample height = 1 ) {
+    std::vector< Sample > samples( size, 0 );
+    for ( const auto &pulse : list )
+        for ( int index = pulse.first; index < pulse.first + pulse.second; ++index )
+            samples[ size_t( index ) ] = height;
+    return samples;
+}
+
+
+static std::vector< double > prefixSum( const std::vector< Sample > &samples ) {
+    std::vector< double > sum( samples.size() + 1, 0.0 );
+    for ( size_t index = 0; index < samples.size(); ++index )
+        sum[ index + 1 ] = sum[ index ] + samples[ index ];
+    return sum;
+}
+
+
+void TestTriggerEngine::edge() {
+    std::vector< Sample > samples( 1000 );
+    for ( size_t index = 0; index < samples.size(); ++index ) // 0 V crossings at 0, 100, 200, ..
+        samples[ index ] = Sample( sin( ( index + 0.25 ) * M_PI / 100 ) );
+    TriggerEngine::Settings settings;
+    TriggerEngine::Result result = TriggerEngine::search( samples, prefixSum( samples ), 50, 1000, settings );
+    QCOMPARE( result.position, 200 );
+    QVERIFY( std::abs( result.offset - 0.25 ) < 0.01 );
+    QVERIFY( std::abs( result.width1 - 100 ) < 0.01 ); // the following positive pulse
+    QVERIFY( std::abs( result.width2 - 100 ) < 0.01 ); // and the negative pulse after it
+    settings.slope = Dso::Slope::Negative;
+    result = TriggerEngine::search( samples, prefixSum( samples ), 50, 1000, settings );
+    QCOMPARE( result.position, 100 );
+    settings.level = 2.0; // out of range
+    result = TriggerEngine::search( samples, prefixSum( samples ), 50, 1000, settings );
+    QCOMPARE( result.position, 0 );
+}
+
+
+void TestTriggerEngine::edgeHysteresis() {
+    // noise around the level before the real edge at 500, two samples on each side to pass the edge check
+    std::vector< Sample > samples = pulses( 1000, { { 500, 200 } } );
+    for ( size_t index = 100; index < 300; ++index )
+        samples[ index ] = index / 2 % 2 ? 0.55f : 0.45f;
+    TriggerEngine::Settings settings;
+    settings.level = 0.5;
+    std::vector< TriggerEngine::Result > events;
+    TriggerEngine::search( samples, prefixSum( samples ), 1, 1000, settings, &events );
+    QCOMPARE( int( events.size() ), 51 ); // every rising step of the noise
+    settings.hysteresis = 0.1;
+    events.clear();
+    TriggerEngine::search( samples, prefixSum( samples ), 1, 1000, settings, &events );
+    QCOMPARE( int( events.size() ), 2 ); // the noise does not leave the hysteresis band
+    QCOMPARE( events[ 0 ].position, 102 );
+    QCOMPARE( events[ 1 ].position, 500 );
+}
+
+
+void TestTriggerEngine::edgeAverage() {
+    // a glitch of 2 samples at 200 before the real edge at 500
+    const std::vector< Sample > samples = pulses( 1000, { { 200, 2 }, { 500, 200 } } );
+    TriggerEngine::Settings settings;
+    settings.level = 0.5;
+    TriggerEngine::Result result = TriggerEngine::search( samples, prefixSum( samples ), 1, 1000, settings );
+    QCOMPARE( result.position, 200 );
+    settings.average = 10;
+    result = TriggerEngine::search( samples, prefixSum( samples ), 10, 990, settings );
+    QCOMPARE( result.position, 500 );
+}
+
+
+void TestTriggerEngine::pulseWidth() {
+    const std::vector< Sample > samples = pulses( 3000, { { 200, 10 }, { 1000, 30 }, { 2000, 5 } } );
+    const std::vector< double > sum = prefixSum( samples );
+    TriggerEngine::Settings settings;
+    settings.type = Dso::TriggerType::PulseWidth;
+    settings.level = 0.5;
+    settings.condition = Dso::TriggerCondition::Greater;
+    settings.time1 = 20;
+    TriggerEngine::Result result = TriggerEngine::search( samples, sum, 1, 3000, settings );
+    QCOMPARE( result.position, 1030 ); // the event is the end of the pulse
+    QCOMPARE( result.width1, 30.0 );
+    settings.condition = Dso::TriggerCondition::Less;
+    settings.time1 = 8;
+    result = TriggerEngine::search( samples, sum, 1, 3000, settings );
+    QCOMPARE( result.position, 2005 );
+    QCOMPARE( result.width1, 5.0 );
+    settings.slope = Dso::Slope::Negative; // the gaps between the pulses
+    settings.condition = Dso::TriggerCondition::Within;
+    settings.time1 = 700;
+    settings.time2 = 900;
+    result = TriggerEngine::search( samples, sum, 1, 3000, settings );
+    QCOMPARE( result.position, 1000 );
+    QCOMPARE( result.width1, 790.0 );
+}
+
+
+void TestTriggerEngine::runt() {
+    // a runt pulse to 0.7 V and a full pulse to 1.5 V
+    std::vector< Sample > samples = pulses( 3000, { { 500, 20 } }, 0.7f );
+    for ( size_t index = 1500; index < 1520; ++index )
+        samples[ index ] = 1.5f;
+    TriggerEngine::Settings settings;
+    settings.type = Dso::TriggerType::Runt;
+    settings.level = 0.5;
+    settings.height = 0.5;
+    const TriggerEngine::Result result = TriggerEngine::search( samples, prefixSum( samples ), 1, 3000, settings );
+    QCOMPARE( result.position, 520 ); // the runt is detected when it falls back
+}
+
+
+void TestTriggerEngine::window() {
+    std::vector< Sample > samples = pulses( 3000, { { 500, 20 } }, 0.7f );
+    for ( size_t index = 1500; index < 1520; ++index )
+        samples[ index ] = 1.5f;
+    const std::vector< double > sum = prefixSum( samples );
+    TriggerEngine::Settings settings;
+    settings.level = 0.5;
+    settings.height = 0.5;
+    settings.type = Dso::TriggerType::WindowExit;
+    TriggerEngine::Result result = TriggerEngine::search( samples, sum, 1, 3000, settings );
+    QCOMPARE( result.position, 1500 );
+    settings.type = Dso::TriggerType::WindowEnter;
+    settings.slope = Dso::Slope::Negative;
+    result = TriggerEngine::search( samples, sum, 1, 3000, settings );
+    QCOMPARE( result.position, 1520 );
+}
+
+
+void TestTriggerEngine::slewRate() {
+    // a slow rising ramp of 100 samples and a fast falling ramp of 10 samples
+    std::vector< Sample > samples( 3000, 0 );
+    for ( size_t index = 100; index < 300; ++index )
+        samples[ index ] = index < 200 ? ( index - 100 ) / 100.0f : 1.0f;
+    for ( size_t index = 300; index < 310; ++index )
+        samples[ index ] = 1.0f - ( index - 300 ) / 10.0f;
+    const std::vector< double > sum = prefixSum( samples );
+    TriggerEngine::Settings settings;
+    settings.type = Dso::TriggerType::SlewRate;
+    settings.slope = Dso::Slope::Both;
+    settings.level = 0.2;
+    settings.height = 0.6;
+    settings.condition = Dso::TriggerCondition::Less;
+    settings.time1 = 20;
+    TriggerEngine::Result result = TriggerEngine::search( samples, sum, 1, 3000, settings );
+    QCOMPARE( result.position, 308 );
+    QVERIFY( std::abs( result.width1 - 6 ) < 0.01 );
+    settings.condition = Dso::TriggerCondition::Greater;
+    result = TriggerEngine::search( samples, sum, 1, 3000, settings );
+    QCOMPARE( result.position, 180 );
+    QVERIFY( std::abs( result.width1 - 60 ) < 0.01 );
+}
+
+
+void TestTriggerEngine::timeout() {
+    const std::vector< Sample > samples = pulses( 3000, { { 500, 10 }, { 1500, 20 } } );
+    TriggerEngine::Settings settings;
+    settings.type = Dso::TriggerType::Timeout;
+    settings.level = 0.5;
+    settings.time1 = 15; // the signal stays high longer than 15 samples
+    const TriggerEngine::Result result = TriggerEngine::search( samples, prefixSum( samples ), 1, 3000, settings );
+    QCOMPARE( result.position, 1515 );
+}
+
+
+void TestTriggerEngine::allEvents() {
+    const std::vector< Sample > samples = pulses( 1000, { { 100, 10 }, { 300, 10 }, { 500, 10 }, { 900, 10 } } );
+    TriggerEngine::Settings settings;
+    settings.level = 0.5;
+    std::vector< TriggerEngine::Result > events;
+    const TriggerEngine::Result result = TriggerEngine::search( samples, prefixSum( samples ), 200, 800, settings, &events );
+    QCOMPARE( result.position, 300 );
+    QCOMPARE( int( events.size() ), 2 );
+    QCOMPARE( events[ 0 ].position, 300 );
+    QCOMPARE( events[ 1 ].position, 500 );
+}
+
+
+void TestTriggerEngine::mayTrigger() {
+    // two interleaved channels, voltage = ( code - 128 ) * 0.01
+    std::vector< uint8_t > data( 2000, 128 );
+    TriggerEngine::Settings settings;
+    settings.level = 0.5;
+    QVERIFY( !TriggerEngine::mayTrigger( data.data(), 2, 0, 1000, 128, 0.01, settings ) );
+    data[ 1001 ] = 200; // CH2 reaches 0.72 V
+    QVERIFY( !TriggerEngine::mayTrigger( data.data(), 2, 0, 1000, 128, 0.01, settings ) );
+    QVERIFY( TriggerEngine::mayTrigger( data.data(), 2, 1, 1000, 128, 0.01, settings ) );
+    settings.level = -0.05; // needs values below -0.15 V and above 0.05 V
+    settings.hysteresis = 0.1;
+    QVERIFY( !TriggerEngine::mayTrigger( data.data(), 2, 1, 1000, 128, 0.01, settings ) );
+    data[ 1003 ] = 100; // -0.28 V
+    QVERIFY( TriggerEngine::mayTrigger( data.data(), 2, 1, 1000, 128, 0.01, settings ) );
+    // runt: the 2nd level is crossable even if the trigger level is not
+    settings.type = Dso::TriggerType::Runt;
+    settings.level = 2.0;
+    settings.height = -1.5;
+    settings.hysteresis = 0.0;
+    QVERIFY( TriggerEngine::mayTrigger( data.data(), 2, 1, 1000, 128, 0.01, settings ) );
+}
+
+
+QTEST_APPLESS_MAIN( TestTriggerEngine )
+#include "tst_triggerengine.moc"